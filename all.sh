@@ -25,6 +25,8 @@ check out.{a,b}-test.txt
 check out.{a,b}-import_test.txt
 check out.{a,b}-io_test.txt
 
+python3 bench/compare.py --report out.compare.json  # with the workloads
+
 cmake --install .
 echo
 echo "You're invited to play the snake game with the following command"
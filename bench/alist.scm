@@ -0,0 +1,20 @@
+;; joins of association lists on their keys
+
+(define (table n f)
+  (let loop ((i n) (r '()))
+    (if (zero? i) r
+      (loop (- i 1) (cons (cons i (f i)) r)))))
+(define people (table 400 (lambda (i) (* i 3))))
+(define orders (table 800 (lambda (i) (+ 1 (- i (* 400 (/ i 400)))))))
+
+(define (join a b)
+  (let loop ((r b) (out '()))
+    (if (null? r) (reverse out)
+      (let ((p (assoc (cdar r) a)))
+        (loop (cdr r)
+              (if p (cons (list (caar r) (cdar r) (cdr p)) out) out))))))
+(define (sum-last l s)
+  (if (null? l) s (sum-last (cdr l) (+ s (caddr (car l))))))
+
+(define j (join people orders))
+(display (length j) " " (sum-last j 0) "\n")
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+#
+# Runs a corpus of scripts through Humble.py and humble, checks that
+# the outputs are equal, and records the speed ratio and peak RSS of
+# each into a json report.  Exit status is 1 when any output differs.
+#
+# usage: bench/compare.py [--humble PATH] [--report FILE] [script ...]
+
+import argparse
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CORPUS = ["test.scm", "import_test/main.scm", "io_test.scm"] \
+    + sorted(os.path.relpath(p, ROOT)
+             for p in glob.glob(os.path.join(ROOT, "bench", "*.scm")))
+POLL = 0.002  # seconds between reads of the peak RSS
+
+
+def vm_hwm(pid):
+    """Gives the peak RSS in KiB of a running process, else 0."""
+    try:
+        with open("/proc/%d/status" % pid) as f:
+            for line in f:
+                if line.startswith("VmHWM:"):
+                    return int(line.split()[1])
+    except OSError:
+        pass
+    return 0
+
+
+def run(cmd):
+    """Gives output, wall seconds and peak RSS in KiB of a run."""
+    t = time.monotonic()
+    p = subprocess.Popen(cmd, cwd=ROOT, stdin=subprocess.DEVNULL,
+                         stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    # note: ru_maxrss from wait4 counts this process as it was at the
+    #       fork, so the mark of the child alone is read while it runs
+    peak = [0]
+    done = threading.Event()
+
+    def poll():
+        while not done.is_set():
+            peak[0] = max(peak[0], vm_hwm(p.pid))
+            done.wait(POLL)
+    poller = threading.Thread(target=poll)
+    poller.start()
+    out = p.stdout.read()
+    os.waitid(os.P_PID, p.pid, os.WEXITED | os.WNOWAIT)
+    t = time.monotonic() - t
+    done.set()
+    poller.join()
+    _, status, _ = os.wait4(p.pid, 0)
+    p.returncode = os.waitstatus_to_exitcode(status)  # note: reaped here
+    return out, t, peak[0], p.returncode
+
+
+def nosym(out):
+    # note: gensym numbering differs between the implementations
+    return re.sub(rb"&[0-9]+", b"SYM", out)
+
+
+def first_diff(a, b):
+    """Gives the line number where the outputs part, or None."""
+    x, y = a.split(b"\n"), b.split(b"\n")
+    for i, (u, v) in enumerate(zip(x, y)):
+        if u != v:
+            return i + 1
+    return None if len(x) == len(y) else min(len(x), len(y)) + 1
+
+
+def compare(script, humble):
+    a, ta, ma, ra = run([os.path.join(ROOT, "Humble.py"), script])
+    b, tb, mb, rb = run([humble, script])
+    line = first_diff(nosym(a), nosym(b))
+    return {
+        "script": script,
+        "same": line is None and ra == rb,
+        "diff-line": line,
+        "python-status": ra,
+        "humble-status": rb,
+        "python-seconds": round(ta, 4),
+        "humble-seconds": round(tb, 4),
+        "speedup": round(ta / tb, 2) if tb > 0 else None,
+        "python-rss-kb": ma,
+        "humble-rss-kb": mb,
+    }
+
+
+def main():
+    p = argparse.ArgumentParser()
+    p.add_argument("--humble", default=os.path.join(ROOT, "humble"))
+    p.add_argument("--report", default="out.compare.json")
+    p.add_argument("scripts", nargs="*", default=CORPUS)
+    o = p.parse_args()
+    humble = os.path.abspath(o.humble)
+    rows = []
+    for s in o.scripts:
+        r = compare(s, humble)
+        rows.append(r)
+        print("%-24s %-4s %8.3fs %8.3fs %7sx %8d %8d KB" % (
+            s, "ok" if r["same"] else "DIFF",
+            r["python-seconds"], r["humble-seconds"], r["speedup"],
+            r["python-rss-kb"], r["humble-rss-kb"]))
+    with open(o.report, "w") as f:
+        json.dump({"humble": humble, "results": rows}, f, indent=1)
+        f.write("\n")
+    return 0 if all(r["same"] for r in rows) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,41 @@
+;; bodies under a pull towards each other, in integer fixed point
+
+(define scale 1000)
+(define (body x y vx vy) (list x y vx vy))
+(define (pull d)
+  (cond ((> d 0) (- 0 (+ 1 (/ d 64))))
+        ((< d 0) (+ 1 (/ (- 0 d) 64)))
+        (else 0)))
+(define (accel b bodies)
+  (let loop ((r bodies) (ax 0) (ay 0))
+    (if (null? r)
+      (list ax ay)
+      (let ((o (car r)))
+        (loop (cdr r)
+              (+ ax (pull (- (car b) (car o))))
+              (+ ay (pull (- (cadr b) (cadr o)))))))))
+(define (step bodies)
+  (map (lambda (b)
+         (let* ((a (accel b bodies))
+                (vx (+ (caddr b) (car a)))
+                (vy (+ (car (cdddr b)) (cadr a))))
+           (body (+ (car b) vx) (+ (cadr b) vy) vx vy)))
+       bodies))
+(define (energy bodies)
+  (if (null? bodies) 0
+    (let ((b (car bodies)))
+      (+ (* (caddr b) (caddr b))
+         (* (car (cdddr b)) (car (cdddr b)))
+         (energy (cdr bodies))))))
+
+(define start
+  (list (body 0 0 0 0)
+        (body (* 5 scale) 0 0 30)
+        (body 0 (* 7 scale) -25 0)
+        (body (* -9 scale) 0 0 -20)
+        (body 0 (* -11 scale) 15 0)))
+(define (run bodies k)
+  (if (zero? k) bodies (run (step bodies) (- k 1))))
+(define end (run start 400))
+(display (energy end) "\n")
+(display (map car end) "\n")
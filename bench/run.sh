@@ -0,0 +1,17 @@
+#!/usr/bin/env bash
+# Runs the workloads with humble --stats, reporting wall time and
+# the vars allocated.  Give another interpreter as first argument.
+
+H=$(realpath "${1:-$(dirname "$0")/../humble}")
+cd "$(dirname "$0")"
+printf "%-12s %10s %12s %12s\n" script wall-ms vars-made peak-bytes
+for s in *.scm
+do
+  t0=$(date +%s%N)
+  "$H" --stats "$s" > /dev/null 2> out.stats || { echo "$s: failed"; exit 1; }
+  t1=$(date +%s%N)
+  made=$(awk '$1 == "var" && $2 == "made" { print $3 }' out.stats)
+  peak=$(awk '$1 == "bytes" { print $4 }' out.stats)
+  printf "%-12s %10d %12s %12s\n" "${s%.scm}" $(( (t1 - t0) / 1000000 )) "$made" "$peak"
+done
+rm -f out.stats
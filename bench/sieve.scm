@@ -0,0 +1,18 @@
+;; primes below n, by a list of flags for the odd numbers
+
+(define n 20000)
+(define m (/ n 2))
+(define odd-primes (make-list m #t))
+(do ((i 3 (+ i 2)))
+  ((>= (* i i) n))
+  (when (list-ref odd-primes (/ i 2))
+    (let loop ((k (* i i)))
+      (when (< k n)
+        (list-set! odd-primes (/ k 2) #f)
+        (loop (+ k i i))))))
+
+(define (count-true l c)
+  (cond ((null? l) c)
+        ((car l) (count-true (cdr l) (+ c 1)))
+        (else (count-true (cdr l) c))))
+(display (count-true (cdr odd-primes) 1) "\n")
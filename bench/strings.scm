@@ -0,0 +1,24 @@
+;; building of strings, piecewise and by joining
+
+(define (digits n)
+  (let loop ((i 0) (s ""))
+    (if (= i n) s
+      (loop (+ i 1) (string-append s (number->string (* i i)) ",")))))
+(define (join l sep)
+  (if (null? l) ""
+    (let loop ((r (cdr l)) (s (car l)))
+      (if (null? r) s
+        (loop (cdr r) (string-append s sep (car r)))))))
+(define (words n)
+  (let loop ((i n) (r '()))
+    (if (zero? i) r
+      (loop (- i 1) (cons (string-append "w" (number->string i)) r)))))
+
+(define (repeat k total)
+  (if (zero? k) total
+    (repeat (- k 1)
+            (+ total
+               (string-length (digits 300))
+               (string-length (join (words 300) " "))))))
+(display (repeat 20 0) "\n")
+(display (substring (join (words 12) "-") 0 20) "\n")
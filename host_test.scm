@@ -0,0 +1,89 @@
+; Cases of builtins and behavior only humble has, so they are run
+; by ctest and not diffed against Humble.py as test.scm is.
+(macro chk (x y)
+  (let ((a (gensym)) (b (gensym)))
+  `(let ((,a ,x) (,b ,y))
+    (unless (equal? ,a ,b) (error (list ,a ,b))))))
+
+; equal? walks deep nesting without recursion, and ends on cycles
+(ref (nest n) (let loop ((i n) (a '())) (if (zero? i) a (loop (- i 1) (list a)))))
+(chk #t (equal? (nest 3000) (nest 3000)))
+(chk #f (equal? (nest 3000) (nest 2999)))
+(chk #f (equal? '(1 2) '(1 . 2)))
+(chk #t (equal? (cons 1 (list 2)) '(1 2)))
+(ref (ring . x) (ref r (apply list x)) (set-cdr! (list-tail r (- (length x) 1)) r) r)
+(chk #t (equal? (ring 1 2) (ring 1 2)))
+(chk #t (equal? (ring 1 2) (ring 1 2 1 2)))
+(chk #f (equal? (ring 1 2) (ring 1 3)))
+(chk #f (equal? (ring 1 2) '(1 2)))
+; sort is stable, with builtin or lambda comparators
+(chk '(1 2 3) (sort '(3 1 2)))
+(chk '(3 2 1) (sort '(3 1 2) >))
+(chk '("a" "b" "c") (sort '("b" "c" "a") string<?))
+(chk '() (sort '()))
+(chk '(1 2) (sort (cons 2 (list 1))))
+(chk '((0 . b) (0 . d) (1 . a) (1 . c))
+  (list-sort (lambda (a b) (< (car a) (car b)))
+    '((1 . a) (0 . b) (1 . c) (0 . d))))
+(chk '((1 . a) (1 . c) (0 . b) (0 . d))
+  (sort '((1 . a) (0 . b) (1 . c) (0 . d))
+    (lambda (a b) (> (car a) (car b)))))
+; for-each, filter, fold and friends walk lists in step
+(chk '(3 2 1) (fold cons '() '(1 2 3)))
+(chk '(((() . 1) . 2) . 3) (fold-left cons '() '(1 2 3)))
+(chk '(1 2 3) (fold-right cons '() '(1 2 3)))
+(chk 33 (fold + 0 '(1 2) '(10 20)))
+(chk '((() 1 3) 2 4) (fold-left list '() '(1 2) '(3 4)))
+(chk '(1 3 (2 4 z)) (fold-right list 'z '(1 2) '(3 4 5)))
+(chk 6 (reduce + 0 '(1 2 3)))
+(chk 0 (reduce + 0 '()))
+(chk 2 (count even? '(1 2 4)))
+(chk 2 (find even? '(1 2 4)))
+(chk #f (find even? '(1 3)))
+(chk #f (any even? '(1 3)))
+(chk 4 (any (lambda (x) (and (even? x) x)) '(1 4 3)))
+(chk #t (every even? '(2 4)))
+(chk #f (every even? '(2 3)))
+(chk #t (every even? '()))
+(chk '(2) (filter even? '(1 2 3)))
+(chk '() (filter even? '(1)))
+(chk #t (null? (filter even? '(1))))
+(chk '(11 22) (map + '(1 2) '(10 20 30)))
+(chk #t (null? (map car '())))
+(chk 10 (let ((a 0)) (for-each (lambda (x y) (set! a (+ a x y))) '(1 2) '(3 4)) a))
+; a string not well formed has one length, by the bytes not continuation
+(chk '(2 97 2) (let ((s "\303a")) (list (string-length s) (string-ref s 1) (string-length s))))
+; substring-index and string-search-all count from the start given
+(chk #t (null? (string-search-all "abc" "x")))
+(chk '(0 2 4) (string-search-all "aéaéa" "a"))
+(chk '(2 4) (string-search-all "aéaéa" "a" 1))
+(chk '(1 3) (string-search-all "aéaéa" (make-string-pattern "é")))
+(chk 2 (substring-index "aéaéa" "a" 1))
+(chk 3 (substring-index "aéaéa" "é" 2))
+(chk -1 (substring-index "aéaéa" "x" 2))
+; string-split gives a list, if empty, and the ends by the separator
+(chk #t (null? (string-split "")))
+(chk #t (null? (string-split "   ")))
+(chk '("a" "b") (string-split "  a \t b\n"))
+(chk '("") (string-split "" ","))
+(chk '("" "a" "") (string-split ",a," ","))
+(chk '("a" "" "b") (string-split "a,,b" ","))
+(chk '("" "") (string-split "::" "::"))
+; read-csv-row: quoted fields, delimiters in them, crlf, blank line and eof
+(define (csv-rows-by s read)
+  (let ((p (open-input-string s)))
+    (let loop ((r '()))
+      (let ((x (read p)))
+        (if (eof-object? x) (reverse r) (loop (cons x r)))))))
+(define (csv-rows s) (csv-rows-by s read-csv-row))
+(chk '(("a" "b" "c")) (csv-rows "a,b,c\n"))
+(chk '(("a,b" "say \"hi\"" "")) (csv-rows "\"a,b\",\"say \"\"hi\"\"\",\n"))
+(chk '(("x\ny" "z")) (csv-rows "\"x\ny\",z"))
+(chk '(("a" "b") ("c" "")) (csv-rows "a,b\r\nc,\r\n"))
+(chk '(("a") () ("b")) (csv-rows "a\n\nb"))
+(chk #t (null? (car (csv-rows "\n"))))
+(chk '(("") ("")) (csv-rows "\"\"\n\"\"\r\n"))
+(chk '(("a" "b;c"))
+     (csv-rows-by "a;'b;c'\n" (lambda (p) (read-csv-row p 59 39))))
+(chk '() (csv-rows ""))
+(chk #t (eof-object? (read-csv-row (open-input-string ""))))
@@ -39,7 +39,7 @@ EnvEntry f_nc_initscr(span<EnvEntry> args)
     auto r = VarExt{t_nc_stdscr};
     r.u = w;
     r.f = delete_nc_stdscr;
-    return make_shared<Var>(VarExt{move(r)});
+    return make_var(VarExt{move(r)});
 }
 
 EnvEntry f_nc_getmaxyx(span<EnvEntry> args)
@@ -50,9 +50,9 @@ EnvEntry f_nc_getmaxyx(span<EnvEntry> args)
     int y{};
     int x{};
     getmaxyx(w, y, x);
-    return make_shared<Var>(VarList{{
-        make_shared<Var>(VarNum{y}),
-        make_shared<Var>(VarNum{x})}});
+    return make_var(VarList{{
+        make_var(VarNum{y}),
+        make_var(VarNum{x})}});
 }
 
 EnvEntry f_nc_addstr(span<EnvEntry> args)
@@ -81,7 +81,7 @@ EnvEntry f_nc_addstr(span<EnvEntry> args)
         i += g.u.size();
     }
     mvwaddnwstr(w, y, x, t.data(), t.size());
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_nc_getch(span<EnvEntry> args)
@@ -94,14 +94,14 @@ EnvEntry f_nc_getch(span<EnvEntry> args)
         (void)endwin();
         exit(1);
     }
-    return make_shared<Var>(VarNum{r});
+    return make_var(VarNum{r});
 }
 
 EnvEntry f_nc_endwin(span<EnvEntry> args)
 {
     (void)args;
     (void)endwin();
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 extern "C" void xdl_curses(void * a)
@@ -109,7 +109,7 @@ extern "C" void xdl_curses(void * a)
     auto p = static_cast<xdl_arg *>(a);
     Names & n = *p->names;
     GlobalEnv & g = *p->env;
-    t_nc_stdscr = n.intern("nc-stdscr");
+    ext_type(t_nc_stdscr, n, "nc-stdscr");
     typedef EnvEntry (*hp)(span<EnvEntry> args);
     for (auto & p : initializer_list<pair<string, hp>>{
             { "nc-initscr", f_nc_initscr },
@@ -117,6 +117,6 @@ extern "C" void xdl_curses(void * a)
             { "nc-addstr", f_nc_addstr },
             { "nc-getch", f_nc_getch },
             { "nc-endwin", f_nc_endwin },
-    }) g.set(n.intern(p.first), make_shared<Var>(VarFunHost{ p.second }));
+    }) g.set(n.intern(p.first), make_var(VarFunHost{ p.second }));
 }
 
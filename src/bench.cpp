@@ -0,0 +1,151 @@
+#include "interp.hpp"
+#include "compx.hpp"
+#include "cons.hpp"
+#include "benchmark/benchmark.h"
+#include <sstream>
+
+using namespace humble;
+using namespace std;
+
+namespace {
+
+Interpreter & humble()
+{
+    static Interpreter h{"/usr/share/humble"};
+    return h;
+}
+
+// note: definitions once, then the timed expression per iteration
+void run_snippet(benchmark::State & state, const string & defs,
+        const string & expr)
+{
+    auto & h = humble();
+    h.run("(define (upto n) (let loop ((i n) (r '()))"
+            " (if (eqv? i 0) r (loop (- i 1) (cons i r)))))" + defs);
+    auto & x = h.compile(expr);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(h.run(x));
+}
+
+string big_source(int n)
+{
+    ostringstream oss;
+    for (int i = 0; i != n; ++i)
+        oss << "(define (f" << i << " x y) (if (< x y) (+ x " << i
+            << ") (list \"s" << i << "\" 'y x)))\n";
+    return oss.str();
+}
+
+void BM_lex(benchmark::State & state)
+{
+    auto s = big_source(1000);
+    Names n;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(lex(s, n));
+    state.SetBytesProcessed(state.iterations() * s.size());
+}
+BENCHMARK(BM_lex);
+
+void BM_compx(benchmark::State & state)
+{
+    auto & h = humble();
+    Interpreter::Use u(h);
+    auto s = big_source(200);
+    for (auto _ : state) {
+        vector<LexEnv *> e;
+        auto t = compx(parse(s, h.names, h.macros), h.names,
+                h.env.keys(), e);
+        benchmark::DoNotOptimize(t);
+        compx_dispose(e);
+    }
+    state.SetBytesProcessed(state.iterations() * s.size());
+}
+BENCHMARK(BM_compx);
+
+void BM_closure_call(benchmark::State & state)
+{
+    run_snippet(state, "(define (k x) x)", "(k 1)");
+}
+BENCHMARK(BM_closure_call);
+
+void BM_tco_loop(benchmark::State & state)
+{
+    run_snippet(state,
+            "(define (count n) (let loop ((i 0))"
+            " (if (eqv? i n) i (loop (+ i 1)))))",
+            "(count 1000)");
+}
+BENCHMARK(BM_tco_loop);
+
+void BM_to_cons(benchmark::State & state)
+{
+    vector<EnvEntry> v;
+    for (int i = 0; i != 1000; ++i)
+        v.push_back(make_var(VarNum{i}));
+    for (auto _ : state) {
+        Var x = VarList{v};
+        benchmark::DoNotOptimize(to_cons(x));
+    }
+}
+BENCHMARK(BM_to_cons);
+
+void BM_normal_list(benchmark::State & state)
+{
+    vector<EnvEntry> v;
+    for (int i = 0; i != 1000; ++i)
+        v.push_back(make_var(VarNum{i}));
+    Var x = VarList{v};
+    to_cons(x);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(normal_list(x));
+}
+BENCHMARK(BM_normal_list);
+
+void BM_equal(benchmark::State & state)
+{
+    run_snippet(state,
+            "(define a (upto 1000)) (define b (upto 1000))",
+            "(equal? a b)");
+}
+BENCHMARK(BM_equal);
+
+void BM_append(benchmark::State & state)
+{
+    run_snippet(state,
+            "(define a (upto 1000)) (define b (upto 1000))",
+            "(append a b)");
+}
+BENCHMARK(BM_append);
+
+void BM_string_ops(benchmark::State & state)
+{
+    run_snippet(state,
+            "(define s (string-join (map number->string (upto 200)) \",\"))",
+            "(string-length (string-upcase (string-append s s)))"
+            " (string-split s \",\")");
+}
+BENCHMARK(BM_string_ops);
+
+void BM_port_write(benchmark::State & state)
+{
+    run_snippet(state,
+            "(define s (string-join (map number->string (upto 200)) \" \"))",
+            "(let ((p (open-output-string)))"
+            " (write-string s p) (write-string s p)"
+            " (output-string-get p))");
+}
+BENCHMARK(BM_port_write);
+
+void BM_port_read(benchmark::State & state)
+{
+    run_snippet(state,
+            "(define s (string-join (map number->string (upto 500)) \"\\n\"))"
+            "(define (lines p n) (if (eof-object? (read-line p)) n"
+            " (lines p (+ n 1))))",
+            "(lines (open-input-string s) 0)");
+}
+BENCHMARK(BM_port_read);
+
+} // ans
+
+BENCHMARK_MAIN();
@@ -7,6 +7,7 @@
 #include "debug.hpp"
 #include <iostream>
 #include <sstream>
+#include <charconv>
 
 using namespace humble;
 using namespace std;
@@ -139,7 +140,38 @@ void report_unbound(set<int> u, LexForm & t, Names & names)
     throw SrcError("unbound," + a.str());
 }
 
-void zloc_scopes(span<Lex> t, LexEnv * local_env, vector<LexEnv *> & local_envs)
+int first_line(span<Lex> t)
+{
+    for (auto & x : t) {
+        int r = 0;
+        if (holds_alternative<LexNam>(x))
+            r = get<LexNam>(x).line;
+        else if (holds_alternative<LexForm>(x))
+            r = first_line(get<LexForm>(x).v);
+        else if (holds_alternative<LexList>(x))
+            r = first_line(get<LexList>(x).v);
+        if (r) return r;
+    }
+    return 0;
+}
+
+// note: a let is a lambda applied, so the lambdas given to it are
+//       labeled by its parameters (negated when for letrec).
+LexArgs let_labels(LexForm & f)
+{
+    if (not holds_alternative<LexForm>(f.v[0]))
+        return {};
+    auto & g = get<LexForm>(f.v[0]);
+    if (g.v.size() < 2 or not holds_alternative<LexOp>(g.v[0])
+            or not holds_alternative<LexArgs>(g.v[1]))
+        return {};
+    LexArgs r = get<LexArgs>(g.v[1]);
+    for (int & z : r) z = abs(z);
+    return r;
+}
+
+void zloc_scopes(span<Lex> t, LexEnv * local_env, vector<LexEnv *> & local_envs,
+        int label)
 {
     for (auto & x : t) {
         if (not holds_alternative<LexForm>(x)) {
@@ -155,17 +187,22 @@ void zloc_scopes(span<Lex> t, LexEnv * local_env, vector<LexEnv *> & local_envs)
             }
         } else if (auto & f = get<LexForm>(x);
                 not holds_alternative<LexOp>(f.v.at(0))) {
-            zloc_scopes(f.v, local_env, local_envs);
+            auto a = let_labels(f);
+            for (size_t i = 0; i != f.v.size(); ++i)
+                zloc_scopes(span1(f.v, i), local_env, local_envs,
+                        i and i <= a.size() ? a[i - 1] : 0);
         } else if (auto & op = get<LexOp>(f.v[0]);
                 op.code == OP_BIND) {
-            if (local_env) {
-                auto & n = get<LexNam>(f.v.at(1));
+            auto & n = get<LexNam>(f.v.at(1));
+            int h = n.h;
+            if (local_env)
                 n.h = local_env->rewrite_name(n.h);
-            }
-            zloc_scopes(span1(f.v, 2), local_env, local_envs);
+            zloc_scopes(span1(f.v, 2), local_env, local_envs, h);
         } else if (op.code == OP_LAMBDA or op.code == OP_LAMBDA_DOT) {
             auto & c = get<LexArgs>(f.v.at(2));
             auto fun_env = new LexEnv(get<LexArgs>(f.v[1]), c);
+            fun_env->label = label;
+            fun_env->line = first_line({f.v.begin() + 3, f.v.end()});
             local_envs.push_back(fun_env);
             zloc_scopes({f.v.begin() + 3, f.v.end()}, fun_env, local_envs);
             f.v[1] = fun_env;
@@ -200,6 +237,8 @@ void compx_dispose(vector<LexEnv *> & local_envs)
 }
 
 LexEnv::LexEnv(const vector<int> & parms, const vector<int> & capture)
+    : label()
+    , line()
 {
         n_parms = parms.size();
         names = parms;
@@ -245,7 +284,7 @@ FunEnv LexEnv::activation(FunEnv & captured, bool dot, span<EnvEntry> args)
         if (args.size() < last)
             throw RunError("fun-dot expected more args");
         copy(args.begin(), args.begin() + last, env.v.begin());
-        env.set(last, make_shared<Var>(VarList{}));
+        env.set(last, make_var(VarList{}));
         copy(args.begin() + last, args.end(),
                 back_inserter(get<VarList>(*env.get(last)).v));
     } else {
@@ -259,13 +298,13 @@ FunEnv LexEnv::activation(FunEnv & captured, bool dot, span<EnvEntry> args)
 static EnvEntry to_list_var(const ConsPtr & c)
 {
     if (not c) {
-        return make_shared<Var>(VarList{});
+        return make_var(VarList{});
     } else {
         auto b = c->to_list_var();
         if (holds_alternative<VarList>(b))
-            return make_shared<Var>(get<VarList>(move(b)));
+            return make_var(get<VarList>(move(b)));
         else
-            return make_shared<Var>(get<VarNonlist>(move(b)));
+            return make_var(get<VarNonlist>(move(b)));
     }
 }
 
@@ -273,6 +312,8 @@ Lex to_lex(EnvEntry a)
 {
     // cerr << "to_lex\n";
     if (not a) throw CoreError("mute variable");
+    if (holds_alternative<VarView>(*a))
+        a = make_var(from_view(get<VarView>(*a)));
     if (holds_alternative<VarCons>(*a)) {
         // cerr << "holds cons\n";
         a = to_list_var(get<VarCons>(*a).c);
@@ -286,7 +327,7 @@ Lex to_lex(EnvEntry a)
                     v.push_back(to_lex(y));
                 return LexForm{ v };
             } else if constexpr (is_same_v<T, VarNonlist>) {
-                auto b = make_shared<Var>(VarList{ q.v });
+                auto b = make_var(VarList{ q.v });
                 return with_dot(get<LexForm>(to_lex(b)));
             } else if constexpr (is_same_v<T, VarBool>) {
                 return LexBool{ q.b };
@@ -330,8 +371,8 @@ EnvEntry from_lex(Lex & x)
                 vector<EnvEntry> v;
                 for (auto & w : q.v)
                     v.push_back(from_lex(w));
-                if (isd) return make_shared<Var>(VarNonlist{v});
-                return make_shared<Var>(VarList{v});
+                if (isd) return make_var(VarNonlist{v});
+                return make_var(VarList{v});
             } else if constexpr (is_same_v<T, LexList>) {
                 vector<Lex> v{ nam_list };
                 move(q.v.begin(), q.v.end(), back_inserter(v));
@@ -347,20 +388,20 @@ EnvEntry from_lex(Lex & x)
                 Lex r = LexForm{ v };
                 return from_lex(r);
             } else if constexpr (is_same_v<T, LexBool>) {
-                return make_shared<Var>(VarBool{ q.b });
+                return make_var(VarBool{ q.b });
             } else if constexpr (is_same_v<T, LexNum>) {
-                return make_shared<Var>(VarNum{ q.i });
+                return make_var(VarNum{ q.i });
             } else if constexpr (is_same_v<T, LexString>) {
-                return make_shared<Var>(VarString{ q.s });
+                return make_var(VarString{ q.s });
             } else if constexpr (is_same_v<T, LexRec>) {
                 vector<EnvEntry> v;
                 for (auto & w : q.v)
                     v.push_back(run(w, nullenv));
-                return make_shared<Var>(VarRec{ v });
+                return make_var(VarRec{ v });
             } else if constexpr (is_same_v<T, LexNam>) {
-                return make_shared<Var>(VarNam{ q.h });
+                return make_var(VarNam{ q.h });
             } else if constexpr (is_same_v<T, LexVoid>) {
-                return make_shared<Var>(VarVoid{});
+                return make_var(VarVoid{});
             } else {
                 ostringstream oss;
                 oss << "lex#" << x.index();
@@ -370,60 +411,132 @@ EnvEntry from_lex(Lex & x)
     }, x);
 }
 
-void print(EnvEntry a, Names & n, std::ostream & os)
+thread_local string print_buffer;
+thread_local bool print_buffer_used;
+
+Printer::Printer(Names & n, ostream & os)
+    : n(n)
+    , os(&os)
+    , b(print_buffer_used ? own : print_buffer)
+    , shared(not print_buffer_used)
 {
-    if (holds_alternative<VarCons>(*a)) {
-        auto & c = get<VarCons>(*a).c;
-        if (not c) {
-            a = make_shared<Var>(VarList{});
-        } else {
-            std::visit([&a](auto && w) {
-                a = make_shared<Var>(w);
-            }, c->to_list_var());
+    print_buffer_used = true;
+    b.clear();
+}
+
+Printer::Printer(Names & n, string & out)
+    : n(n)
+    , os()
+    , b(out)
+    , shared()
+{ }
+
+Printer::~Printer()
+{
+    if (not os) return;
+    flush();
+    if (shared) print_buffer_used = false;
+}
+
+void Printer::flush()
+{
+    if (not os or b.empty()) return;
+    os->write(b.data(), b.size());
+    b.clear();
+}
+
+void Printer::put(string_view s)
+{
+    b += s;
+    if (os and b.size() >= FLUSH_SIZE) flush();
+}
+
+void Printer::num(long long i)
+{
+    char t[24];
+    auto r = to_chars(t, t + sizeof t, i);
+    b.append(t, r.ptr);
+}
+
+// note: as escape() does it
+void Printer::quoted(string_view s)
+{
+    b += '"';
+    for (size_t i; (i = s.find('"')) != s.npos; s.remove_prefix(i + 1)) {
+        b += s.substr(0, i);
+        b += "\\\"";
+    }
+    b += s;
+    b += '"';
+}
+
+void Printer::elements(const vector<EnvEntry> & v, size_t i, bool dot)
+{
+    char c = '(';
+    if (i == v.size()) b += c;
+    for (size_t j = i; j != v.size(); ++j) {
+        if (dot and j + 1 == v.size()) b += " .";
+        b += c;
+        print(v[j]);
+        c = ' ';
+    }
+    b += ')';
+}
+
+void Printer::cons(Cons * c, char c0)
+{
+    b += c0;
+    for (;;) {
+        print(c->a);
+        if (holds_alternative<EnvEntry>(c->d)) {
+            b += " . ";
+            print(get<EnvEntry>(c->d));
+            break;
         }
+        c = get<ConsPtr>(c->d).get();
+        if (not c) break;
+        b += ' ';
     }
-    visit([&n, &os, &a](auto && z) {
+    b += ')';
+}
+
+void Printer::print(const EnvEntry & a)
+{
+    if (os and b.size() >= FLUSH_SIZE) flush();
+    visit([this, &a](auto && z) {
             using T = decay_t<decltype(z)>;
             if constexpr (is_same_v<T, VarList>) {
-                char c = '(';
-                if (z.v.empty())
-                    os << c;
-                for (auto & w : z.v) {
-                    os << c;
-                    print(w, n, os);
-                    c = ' ';
-                }
-                os << ')';
+                elements(z.v, 0, false);
             } else if constexpr (is_same_v<T, VarNonlist>) {
-                auto j = z.v.size();
-                if (j < 2) throw CoreError("short nonlist");
-                char c = '(';
-                for (auto & w : z.v) {
-                    if (0 == --j) os << " .";
-                    os << c;
-                    print(w, n, os);
-                    c = ' ';
-                }
-                os << ')';
+                if (z.v.size() < 2) throw CoreError("short nonlist");
+                elements(z.v, 0, true);
+            } else if constexpr (is_same_v<T, VarView>) {
+                auto & s = *z.s;
+                if (s.cells.empty()) elements(s.v, z.i, s.dot);
+                else cons(s.cells[z.i].get(), '(');
+            } else if constexpr (is_same_v<T, VarCons>) {
+                if (z.c) cons(z.c.get(), '(');
+                else b += "()";
             } else if constexpr (is_same_v<T, VarBool>) {
-                os << (z.b ? "#t" : "#f");
+                b += z.b ? "#t" : "#f";
             } else if constexpr (is_same_v<T, VarNum>) {
-                os << z.i;
+                num(z.i);
             } else if constexpr (is_same_v<T, VarString>) {
-                os << '"' << escape(z.s) << '"';
+                quoted(z.s);
             } else if constexpr (is_same_v<T, VarRec>) {
-                os << "#r";
-                print(make_shared<Var>(VarList{ z.v }), n, os);
+                b += "#r";
+                elements(z.v, 0, false);
             } else if constexpr (is_same_v<T, VarNam>) {
-                os << n.get(z.h);
+                b += n.get(z.h);
             } else if constexpr (is_same_v<T, VarVoid>) {
-                os << "#void";
+                b += "#void";
             } else if constexpr (is_same_v<T, VarFunOps>) {
-                os << "#~fun";
+                b += "#~fun";
             } else if constexpr (is_same_v<T, VarFunHost>) {
-                os << "#~fun-host";
+                b += "#~fun-host";
             } else if constexpr (is_same_v<T, VarExt>) {
-                os << "#~" << n.get(z.t);
+                b += "#~";
+                b += n.get(z.t);
             } else {
                 throw CoreError("unexpected var for print, "
                         + string{var_type_name(*a)});
@@ -431,6 +544,12 @@ void print(EnvEntry a, Names & n, std::ostream & os)
     }, *a);
 }
 
+void print(EnvEntry a, Names & n, std::ostream & os)
+{
+    Printer p(n, os);
+    p.print(a);
+}
+
 bool warn_off;
 
 void warn(const std::string & m)
@@ -20,17 +20,46 @@ public:
     std::vector<int> rewrite_names(const std::vector<int> & c);
     int rewrite_name(int n);
     FunEnv activation(FunEnv & captured, bool dot, std::span<EnvEntry> args);
+    int label;  // name bound to, or zero
+    int line;   // of the first name within
 };
 
 std::set<int> unbound(std::span<Lex> t, std::set<int> & defs, bool is_block);
 void report_unbound(std::set<int> u, LexForm & t, Names & names);
-void zloc_scopes(std::span<Lex> t, LexEnv * local_env, std::vector<LexEnv *> & local_envs);
+void zloc_scopes(std::span<Lex> t, LexEnv * local_env, std::vector<LexEnv *> & local_envs,
+        int label = 0);
 LexForm compx(LexForm && t, Names & names, std::set<int> env_keys, std::vector<LexEnv *> & local_envs);
 void compx_dispose(std::vector<LexEnv *> & local_envs);
 
 Lex to_lex(EnvEntry a);
 EnvEntry from_lex(Lex & x);
 
+// Writes the printed form of vars into a byte buffer, walking
+// cons and view lists where they are.  With a stream, the buffer
+// is the one kept for the thread when free, and it is flushed to
+// the stream when large and at the end.
+class Printer {
+public:
+    Printer(Names & n, std::ostream & os);
+    Printer(Names & n, std::string & out);
+    Printer(const Printer &) = delete;
+    ~Printer();
+    void print(const EnvEntry & a);
+    void put(std::string_view s);
+    void flush();
+    static constexpr size_t FLUSH_SIZE = 1 << 16;
+private:
+    Names & n;
+    std::ostream * os;
+    std::string own;
+    std::string & b;
+    bool shared;
+    void num(long long i);
+    void quoted(std::string_view s);
+    void elements(const std::vector<EnvEntry> & v, size_t i, bool dot);
+    void cons(Cons * c, char c0);
+};
+
 void print(EnvEntry a, Names & n, std::ostream & os);
 
 extern bool warn_off;
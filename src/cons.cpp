@@ -24,15 +24,28 @@ namespace humble {
 
 Cons::Cons(EnvEntry a, ConsNext d) : a(a), d(d) { }
 
+// note: the cells that only this one holds are let go one at a
+//       time, as the destructors would else recurse down the list.
+Cons::~Cons()
+{
+    while (holds_alternative<ConsPtr>(d)) {
+        auto & n = get<ConsPtr>(d);
+        if (not n or n.use_count() != 1)
+            break;
+        ConsPtr p = move(n);
+        d = move(p->d);
+    }
+}
+
 VarCons Cons::xcopy(size_t n, ConsPtr & last)
 {
     if (n == 0) --n;
     // cerr << "xcopy\n";
     auto cur = this;
-    auto r = make_shared<Cons>(cur->a, ConsPtr{});
+    auto r = make_cons(cur->a, ConsPtr{});
     auto c = r;
     while (cons_iter_next(cur)) {
-        c->d = make_shared<Cons>(cur->a, ConsPtr{});
+        c->d = make_cons(cur->a, ConsPtr{});
         c = get<ConsPtr>(c->d);
         if (--n == 0)
             break;
@@ -69,11 +82,11 @@ VarCons Cons::from_list(span<EnvEntry> x, ConsPtr & last)
 {
     if (x.empty())
         return { nullptr };
-    auto r = make_shared<Cons>(Cons{x.back(), ConsPtr{}});
+    auto r = make_cons(x.back(), ConsPtr{});
     last = r;
     auto it = x.rbegin();
     for (++it; it != x.rend(); ++it)
-        r = make_shared<Cons>(Cons{*it, r});
+        r = make_cons(*it, r);
     return { r };
 }
 
@@ -84,10 +97,104 @@ VarCons Cons::from_nonlist(span<EnvEntry> x)
     ConsNext r = x.back();
     auto it = x.rbegin();
     for (++it; it != x.rend(); ++it)
-        r = make_shared<Cons>(Cons{*it, r});
+        r = make_cons(*it, r);
     return { get<ConsPtr>(r) };
 }
 
+ListStore::ListStore(vector<EnvEntry> && v, bool dot)
+    : v(move(v))
+    , dot(dot)
+{ }
+
+size_t ListStore::size() const
+{
+    return cells.empty() ? v.size() - dot : cells.size();
+}
+
+void ListStore::materialize()
+{
+    if (not cells.empty()) return;
+    size_t n = size();
+    cells.resize(n);
+    ConsNext d = dot ? ConsNext{v.back()} : ConsNext{ConsPtr{}};
+    for (size_t k = n; k--; ) {
+        cells[k] = make_cons(v[k], d);
+        d = cells[k];
+    }
+    v.clear();  // note: the cells hold the elements now
+}
+
+EnvEntry view_cdr(VarView & w)
+{
+    auto & s = *w.s;
+    size_t j = w.i + 1;
+    if (j != s.size())
+        return make_var(VarView{w.s, j});
+    if (s.dot)
+        return s.v.back();
+    return make_var(VarCons{});
+}
+
+void to_view(Var & x)
+{
+    if (holds_alternative<VarNonlist>(x)) {
+        auto & v = get<VarNonlist>(x).v;
+        if (v.size() <= 1)
+            throw CoreError("short nonlist");
+        x = VarView{allocate_shared<ListStore>(
+                PoolAlloc<ListStore, HEAP_STORE>{}, move(v), true), 0};
+    } else if (holds_alternative<VarList>(x)) {
+        auto & v = get<VarList>(x).v;
+        if (v.empty())
+            throw CoreError("empty cont-list");
+        x = VarView{allocate_shared<ListStore>(
+                PoolAlloc<ListStore, HEAP_STORE>{}, move(v), false), 0};
+    }
+}
+
+EnvEntry list_cdr(Var & x)
+{
+    if (holds_alternative<VarNonlist>(x)) {
+        auto & v = get<VarNonlist>(x).v;
+        if (v.size() == 2)
+            return v[1];
+    } else if (get<VarList>(x).v.size() == 1) {
+        return make_var(VarCons{});
+    }
+    to_view(x);
+    return view_cdr(get<VarView>(x));
+}
+
+Var from_view(const VarView & w)
+{
+    auto & s = *w.s;
+    if (not s.cells.empty())
+        return VarCons{s.cells[w.i]};
+    vector<EnvEntry> v{s.v.begin() + w.i, s.v.end()};
+    if (s.dot)
+        return VarNonlist{move(v)};
+    return VarList{move(v)};
+}
+
+void view_sync(Var & x)
+{
+    if (not holds_alternative<VarView>(x))
+        return;
+    auto & w = get<VarView>(x);
+    if (w.s->cells.empty())
+        return;
+    ConsPtr c = w.s->cells[w.i];
+    x = VarCons{c};
+}
+
+void unview(Var & x)
+{
+    if (not holds_alternative<VarView>(x))
+        return;
+    get<VarView>(x).s->materialize();
+    view_sync(x);
+}
+
 ConsPtr to_cons_list(Var & x, ConsPtr & last) {
     if (holds_alternative<VarList>(x)) {
         return Cons::from_list(get<VarList>(x).v, last).c;
@@ -101,6 +208,7 @@ ConsPtr to_cons_list(Var & x, ConsPtr & last) {
 ConsPtr to_cons(Var & x)
 {
     // cerr << "to_cons\n";
+    unview(x);
     if (holds_alternative<VarCons>(x))
         return get<VarCons>(x).c;
     ConsPtr ign_last;
@@ -109,6 +217,16 @@ ConsPtr to_cons(Var & x)
 
 ConsPtr to_cons_copy(Var & x, ConsPtr & last)
 {
+    view_sync(x);
+    if (holds_alternative<VarView>(x)) {
+        auto & w = get<VarView>(x);
+        span<EnvEntry> e{w.s->v.begin() + w.i, w.s->v.end()};
+        if (w.s->dot) {
+            last = nullptr;
+            return Cons::from_nonlist(e).c;
+        }
+        return Cons::from_list(e, last).c;
+    }
     if (holds_alternative<VarCons>(x)) {
         auto c = get<VarCons>(x).c;
         if (c == nullptr) return c;
@@ -120,6 +238,13 @@ ConsPtr to_cons_copy(Var & x, ConsPtr & last)
 
 VarList normal_list(Var & x)
 {
+    view_sync(x);
+    if (holds_alternative<VarView>(x)) {
+        auto & w = get<VarView>(x);
+        if (w.s->dot)
+            throw RunError("nonlist for list-use");
+        return {{w.s->v.begin() + w.i, w.s->v.end()}};
+    }
     if (holds_alternative<VarCons>(x)) {
         ConsPtr c = get<VarCons>(x).c;
         if (not c)
@@ -132,12 +257,28 @@ VarList normal_list(Var & x)
     return get<VarList>(x);
 }
 
+// note: the var is looked at for each step, as a call made while
+//       iterating may have turned it into cells, and then the rest
+//       is taken from an iterator of what it has become.
 struct ListIter : ConsOrListIter {
-    vector<EnvEntry> & v;
+    Var & x;
     size_t i;
-    ListIter(vector<EnvEntry> & v) : v(v), i() { }
+    unique_ptr<ConsOrListIter> j;
+    ListIter(Var & x) : x(x), i() { }
     EnvEntry get() override
     {
+        if (j)
+            return j->get();
+        if (not holds_alternative<VarList>(x)) {
+            j = make_iter(x);
+            if (not j)
+                return nullptr;
+            for (size_t k = 0; k != i; ++k)
+                if (not j->get())
+                    return nullptr;
+            return j->get();
+        }
+        auto & v = std::get<VarList>(x).v;
         if (i == v.size())
             return nullptr;
         return v[i++];
@@ -158,10 +299,37 @@ struct ConsIter : ConsOrListIter {
     }
 };
 
+// note: the store is held, and looked at for each step as the
+//       cells may be made while iterating.
+struct ViewIter : ConsOrListIter {
+    shared_ptr<ListStore> s;
+    size_t i;
+    unique_ptr<ConsIter> j;
+    ViewIter(VarView & w) : s(w.s), i(w.i)
+    {
+        if (s->dot)
+            throw RunError("nonlist for list-use");
+    }
+    EnvEntry get() override
+    {
+        if (j)
+            return j->get();
+        if (i == s->size())
+            return nullptr;
+        if (s->cells.empty())
+            return s->v[i++];
+        j = make_unique<ConsIter>(s->cells[i]);
+        return j->get();
+    }
+};
+
 std::unique_ptr<ConsOrListIter> make_iter(Var & x)
 {
+    view_sync(x);
+    if (holds_alternative<VarView>(x))
+        return make_unique<ViewIter>( get<VarView>(x) );
     if (holds_alternative<VarList>(x))
-        return make_unique<ListIter>( get<VarList>(x).v );
+        return make_unique<ListIter>(x);
     if (holds_alternative<VarCons>(x))
         return make_unique<ConsIter>( get<VarCons>(x).c );
     return {};
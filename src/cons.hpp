@@ -13,6 +13,7 @@ struct Cons {
     ConsNext d;  // invariant: when EnvEntry not VarCons
 
     Cons(EnvEntry a, ConsNext d);
+    ~Cons();
     VarCons xcopy(size_t n, ConsPtr & last);
     std::variant<VarList, VarNonlist> to_list_var();
     size_t length();
@@ -20,6 +21,33 @@ struct Cons {
     static VarCons from_nonlist(std::span<EnvEntry> x);
 };
 
+template <typename D>
+ConsPtr make_cons(EnvEntry a, D && d)
+{
+    return std::allocate_shared<Cons>(PoolAlloc<Cons, HEAP_CONS>{},
+            std::move(a), std::forward<D>(d));
+}
+
+// Elements of a list that has been taken cdr of, shared by the
+// views (the list itself, and its tails) by index.  Once a cons
+// cell is needed, as for set-cdr! or cons onto a tail, all cells
+// are made and views thereafter stand for the cell at its index.
+struct ListStore {
+    std::vector<EnvEntry> v;
+    bool dot;  // last of v is the tail, from nonlist
+    std::vector<ConsPtr> cells;
+    ListStore(std::vector<EnvEntry> && v, bool dot);
+    size_t size() const;  // of elements, not counting tail
+    void materialize();
+};
+
+void to_view(Var & x);  // contiguous list x becomes view at 0
+EnvEntry view_cdr(VarView & w);
+EnvEntry list_cdr(Var & x);  // x becomes view, unless short
+Var from_view(const VarView & w);  // as list, nonlist or cons
+void view_sync(Var & x);  // x becomes cons when cells are made
+void unview(Var & x);  // x becomes cons
+
 ConsPtr to_cons(Var & x);
 ConsPtr to_cons_list(Var & x, ConsPtr & last);
 ConsPtr to_cons_copy(Var & x, ConsPtr & last);
@@ -3,6 +3,7 @@
 #include "compx.hpp"
 #include "cons.hpp"
 #include "except.hpp"
+#include "profile.hpp"
 #include <span>
 
 using namespace std;
@@ -24,11 +25,22 @@ struct FunOps {
 #endif
 };
 
+FunEnv & fun_captured(FunOps & f) { return f.captured; }
+
+shared_ptr<FunOps> fun_recaptured(FunOps & f, FunEnv && captured)
+{
+    return allocate_shared<FunOps>(PoolAlloc<FunOps, HEAP_FUN>{},
+            move(captured), f.local_env, f.dot, f.block);
+}
+
 EnvEntry tco(FunOps f, span<EnvEntry> args)
 {
     // cout << "tco\n";
     EnvEntry v;
-    // ^ alt: = make_shared<Var>(VarVoid{}); to avoid nullptr
+    // ^ alt: = make_var(VarVoid{}); to avoid nullptr
+    ProfileScope scope(f.local_env);
+    CountScope count(f.local_env);
+    TraceScope trace(f.local_env);
     bool done = false;
     while (not done) {
         auto env = f.local_env
@@ -51,6 +63,9 @@ EnvEntry tco(FunOps f, span<EnvEntry> args)
                     cout << "iter-apply\n";
 #endif
                     f = *z.f;
+                    scope.replace(f.local_env);
+                    count.replace(f.local_env);
+                    trace.replace(f.local_env);
                     done = false;
                 }
             }
@@ -59,18 +74,21 @@ EnvEntry tco(FunOps f, span<EnvEntry> args)
     return v;
 }
 
-EnvEntry fun_call(vector<EnvEntry> v)
+EnvEntry fun_call(span<EnvEntry> v)
 {
 #ifdef DEBUG
     cout << "fun-call\n";
 #endif
-    auto args = span<EnvEntry>{v.begin() + 1, v.end()};
-    auto z = v.at(0);
+    auto args = v.subspan(1);
+    auto z = v[0];
     if (holds_alternative<VarFunHost>(*z)) {
 #ifdef DEBUG
         cout << "native-fun\n";
 #endif
-        auto q = get<VarFunHost>(*z).p(args);
+        auto p = get<VarFunHost>(*z).p;
+        CountScope count(p);
+        TraceScope trace(p);
+        auto q = p(args);
         if (not holds_alternative<VarApply>(*q))
             return q;
         auto & b = get<VarApply>(*q).a;
@@ -97,7 +115,8 @@ VarFunOps make_fun(Env & up, span<Lex> x, int op_code)
     // cout << get<LexNum>(fun_block.front()).i << " make_fun in block\n";
     // cout << &fun_block.front() << " make_fun block\n";
     // cout << fun_block.size() << " make_fun block size\n";
-    return { make_shared<FunOps>(captured, local_env, dot, fun_block) };
+    return { allocate_shared<FunOps>(PoolAlloc<FunOps, HEAP_FUN>{},
+            captured, local_env, dot, fun_block) };
 }
 
 vector<EnvEntry> run_each(span<Lex> v, Env & env)
@@ -118,9 +137,13 @@ vector<EnvEntry> run_each(span<Lex> v, Env & env)
 EnvEntry xapply(vector<EnvEntry> v)
 {
     if (holds_alternative<VarFunOps>(*v.at(0)))
-        return make_shared<Var>(VarApply{v});
-    if (holds_alternative<VarFunHost>(*v.at(0)))
-        return get<VarFunHost>(*v.at(0)).p({v.begin() + 1, v.end()});
+        return make_var(VarApply{v});
+    if (holds_alternative<VarFunHost>(*v.at(0))) {
+        auto p = get<VarFunHost>(*v.at(0)).p;
+        CountScope count(p);
+        TraceScope trace(p);
+        return p({v.begin() + 1, v.end()});
+    }
     throw RunError("apply non-fun");
 }
 
@@ -137,45 +160,46 @@ EnvEntry xeval(Lex & x, Env & env)
             if constexpr (is_same_v<T, LexList>) {
                 auto v = run_each(z.v, env);
                 if (v.empty())
-                    return make_shared<Var>(VarCons{});
-                return make_shared<Var>(VarList{move(v)});
+                    return make_var(VarCons{});
+                return make_var(VarList{move(v)});
             }
             if constexpr (is_same_v<T, LexNonlist>) {
                 auto v = run_each(z.v, env);
                 if (v.empty()) throw CoreError("empty nonlist");
+                unview(*v.back());
                 if (holds_alternative<VarList>(*v.back())) {
                     auto w = move(get<VarList>(*v.back()));
                     v.pop_back();
                     move(w.v.begin(), w.v.end(), back_inserter(v));
-                    return make_shared<Var>(VarList{move(v)});
+                    return make_var(VarList{move(v)});
                 }
                 if (holds_alternative<VarCons>(*v.back())) {
                     ConsPtr cons_last;
-                    auto c = make_shared<Var>(Cons::from_list(
+                    auto c = make_var(Cons::from_list(
                                 {v.begin(), v.begin() + v.size() - 1},
                                 cons_last));
                     if (not cons_last) throw CoreError("empty list");
                     cons_last->d = v.back();
                     return c;
                 }
-                return make_shared<Var>(VarNonlist{move(v)});
+                return make_var(VarNonlist{move(v)});
             }
             if constexpr (is_same_v<T, LexNam>)
                 return env.get(z.h);
             if constexpr (is_same_v<T, LexNum>)
-                return make_shared<Var>(VarNum{z.i});
+                return make_var(VarNum{z.i});
             if constexpr (is_same_v<T, LexBool>)
-                return make_shared<Var>(VarBool{z.b});
+                return make_var(VarBool{z.b});
             if constexpr (is_same_v<T, LexString>)
-                return make_shared<Var>(VarString{z.s});
+                return make_var(VarString{z.s});
             if constexpr (is_same_v<T, LexRec>)
-                return make_shared<Var>(VarRec{run_each(z.v, nullenv)});
+                return make_var(VarRec{run_each(z.v, nullenv)});
             if constexpr (is_same_v<T, LexSym>)
-                return make_shared<Var>(VarNam{z.h});
+                return make_var(VarNam{z.h});
             if constexpr (is_same_v<T, LexVoid>)
-                return make_shared<Var>(VarVoid{});
+                return make_var(VarVoid{});
             if constexpr (is_same_v<T, LexUnquote>)
-                return make_shared<Var>(VarUnquote{&z});
+                return make_var(VarUnquote{&z});
             if constexpr (is_same_v<T, LexQuote>
                     or is_same_v<T, LexQuasiquote>)
                 throw CoreError("eval quote");
@@ -203,7 +227,7 @@ EnvEntry xeval_op(LexForm & f, Env & env)
         // cout << &f.v.back() << " xeval_op\n";
         // cout << "xeval.make_fun -- " << f.v.size() << " " << &f.v.back() << endl;
         // cout << "xeval.make_fun expr " << f.v.back() << endl;
-        return make_shared<Var>(make_fun(env,
+        return make_var(make_fun(env,
                     {f.v.begin() + 1, f.v.end()}, op.code));
     } else if (op.code == OP_COND) {
         for (auto yi = f.v.begin() + 1; yi != f.v.end(); ++yi) {
@@ -235,7 +259,7 @@ EnvEntry xeval_op(LexForm & f, Env & env)
     } else {
         throw CoreError("unknown op");
     }
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 // mishaps: one could think const x propagated from here down would prevent
@@ -4,12 +4,15 @@
 #include "vars.hpp"
 #include "tok.hpp"
 #include <vector>
+#include <span>
 
 namespace humble {
 
 EnvEntry run(Lex & x, Env & env);
 EnvEntry xapply(std::vector<EnvEntry> v);
-EnvEntry fun_call(std::vector<EnvEntry> v);
+EnvEntry fun_call(std::span<EnvEntry> v);
+FunEnv & fun_captured(FunOps & f);
+std::shared_ptr<FunOps> fun_recaptured(FunOps & f, FunEnv && captured);
 
 } // ns
 
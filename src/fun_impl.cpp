@@ -5,7 +5,16 @@ using namespace std;
 
 namespace humble {
 
-Names * u_names;
+thread_local Names * u_names;
+
+void ext_type(int & t, Names & n, const string & s)
+{
+    int h = n.intern(s);
+    if (t == 0)
+        t = h;
+    else if (t != h)
+        throw CoreError("ext type differs, " + s);
+}
 
 VarExt & vext_or_fail(const vector<int> & ts, span<EnvEntry> args, size_t i, string s)
 {
@@ -25,7 +25,11 @@ void valt_or_fail(std::span<EnvEntry> args, size_t i, std::string s)
     throw RunError(oss.str());
 }
 
-extern Names * u_names;
+extern thread_local Names * u_names;  // of the interpreter in use
+
+// note: the ext types are the same in every interpreter, as their
+//       names are interned in the same order, and set by the first.
+void ext_type(int & t, Names & n, const std::string & s);
 
 VarExt & vext_or_fail(const std::vector<int> & ts,
         std::span<EnvEntry> args, size_t i, std::string s);
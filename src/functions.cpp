@@ -7,10 +7,21 @@
 #include "utf.hpp"
 #include "fun_impl.hpp"
 #include "debug.hpp"
+#include "hashtab.hpp"
+#include "search.hpp"
+#include "regex.hpp"
+#include "gc.hpp"
+#include "transfer.hpp"
+#include "pool.hpp"
+#include "profile.hpp"
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
+#include <set>
+#include <atomic>
+#include <exception>
 
 using namespace humble;
 using namespace std;
@@ -21,14 +32,14 @@ EnvEntry setjj(span<EnvEntry> args);
 
 void keeps(EnvEntry & a)
 {
-    if (valt_in<VarCons, VarList, VarNonlist, VarString>(*a))
+    if (valt_in<VarCons, VarList, VarNonlist, VarView, VarString>(*a))
         return;
     auto i = a.use_count();
     if (i == 0)
         throw CoreError("bad assumption on keeps");
     if (i == 1)
         return;
-    EnvEntry b = make_shared<Var>(VarVoid{});
+    EnvEntry b = make_var(VarVoid{});
     vector<EnvEntry> w{b, a};
     setjj(w);
     a = b;
@@ -38,44 +49,55 @@ void keeps(EnvEntry & a)
 // cons, (non)list
 //
 
+EnvEntry list_or_empty(vector<EnvEntry> && r)
+{
+    if (r.empty()) return make_var(VarCons{});
+    return make_var(VarList{move(r)});
+}
+
 EnvEntry f_list(span<EnvEntry> args)
 {
-    if (args.empty()) return make_shared<Var>(VarCons{});
+    if (args.empty()) return make_var(VarCons{});
     for (auto & a : args) keeps(a);
-    return make_shared<Var>(VarList{ { args.begin(), args.end() } });
+    return make_var(VarList{ { args.begin(), args.end() } });
 }
 
 EnvEntry f_nonlist(span<EnvEntry> args)
 {
     for (auto & a : args) keeps(a);
-    return make_shared<Var>(VarNonlist{ { args.begin(), args.end() } });
+    return make_var(VarNonlist{ { args.begin(), args.end() } });
 }
 
 EnvEntry f_list_copy(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("list-copy argc");
-    valt_or_fail<VarList, VarCons>(args, 0, "list-copy");
-    return make_shared<Var>(normal_list(*args[0]));
+    valt_or_fail<VarList, VarCons, VarView>(args, 0, "list-copy");
+    return make_var(normal_list(*args[0]));
 }
 
 EnvEntry f_cons(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("cons argc");
     keeps(args[0]);
-    if (valt_in<VarCons, VarList, VarNonlist>(*args[1])) {
+    if (valt_in<VarCons, VarList, VarNonlist, VarView>(*args[1])) {
         auto c = to_cons(*args[1]);
         *args[1] = VarCons{c};
-        return make_shared<Var>(VarCons{make_shared<Cons>(args[0], c)});
+        return make_var(VarCons{make_cons(args[0], c)});
     }
     keeps(args[1]);
-    return make_shared<Var>(VarNonlist{{args.begin(), args.end()}});
+    return make_var(VarNonlist{{args.begin(), args.end()}});
 }
 
 EnvEntry f_car(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("car argc");
-    valt_or_fail<VarCons, VarList, VarNonlist>(args, 0, "car");
+    valt_or_fail<VarCons, VarList, VarNonlist, VarView>(args, 0, "car");
     Var & v = *args[0];
+    view_sync(v);
+    if (valt_in<VarView>(v)) {
+        auto & w = get<VarView>(v);
+        return w.s->v[w.i];
+    }
     if (valt_in<VarList>(v)) return get<VarList>(v).v[0];
     if (valt_in<VarNonlist>(v)) return get<VarNonlist>(v).v[0];
     auto & d = get<VarCons>(v);
@@ -106,8 +128,15 @@ EnvEntry f_list_ref(span<EnvEntry> args)
     if (args.size() != 2) throw RunError("list-ref argc");
     valt_or_fail<VarNum>(args, 1, "car");
     auto i = get<VarNum>(*args[1]).i;
-    valt_or_fail<VarCons, VarList, VarNonlist>(args, 0, "car");
+    valt_or_fail<VarCons, VarList, VarNonlist, VarView>(args, 0, "car");
     auto & v = *args[0];
+    view_sync(v);
+    if (valt_in<VarView>(v)) {
+        auto & w = get<VarView>(v);
+        if (w.s->size() - w.i <= static_cast<size_t>(i))
+            throw RunError("list-ref index overflow");
+        return w.s->v[w.i + i];
+    }
     if (valt_in<VarCons>(v))
         return c_list_ref(get<VarCons>(v).c, i);
     return v_list_ref((valt_in<VarList>(v))
@@ -117,34 +146,30 @@ EnvEntry f_list_ref(span<EnvEntry> args)
 EnvEntry f_cdr(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("cdr argc");
-    valt_or_fail<VarCons, VarList, VarNonlist>(args, 0, "cdr");
+    valt_or_fail<VarCons, VarList, VarNonlist, VarView>(args, 0, "cdr");
     Var & a = *args[0];
-    if (not valt_in<VarCons>(a)) {
-        if (valt_in<VarNonlist>(a)) {
-            auto & u = get<VarNonlist>(a);
-            if (u.v.size() <= 1)
-                throw CoreError("cdr short nonlist");
-            if (u.v.size() == 2)
-                return u.v[1];
-        }
-        auto c = to_cons(a);
-        a = VarCons{c};
-    }
+    // note: a contiguous list becomes a view, that shares its
+    //       elements with the returned tail.
+    if (valt_in<VarList, VarNonlist>(a))
+        return list_cdr(a);
+    view_sync(a);
+    if (valt_in<VarView>(a))
+        return view_cdr(get<VarView>(a));
     VarCons & r = get<VarCons>(a);
     if (not r.c) throw RunError("cdr on null");
     if (holds_alternative<EnvEntry>(r.c->d))
         return get<EnvEntry>(r.c->d);
-    return make_shared<Var>(VarCons{get<ConsPtr>(r.c->d)});
+    return make_var(VarCons{get<ConsPtr>(r.c->d)});
 }
 
 EnvEntry f_append(span<EnvEntry> args)
 {
-    if (args.size() == 0) return make_shared<Var>(VarCons{});
+    if (args.size() == 0) return make_var(VarCons{});
     if (args.size() == 1) return args[0];
     size_t i_last = args.size() - 1;
     keeps(args[i_last]);
     auto last = args[i_last];
-    if (valt_in<VarList, VarNonlist>(*last)) {
+    if (valt_in<VarList, VarNonlist, VarView>(*last)) {
         auto c = to_cons(*last);
         *last = VarCons{c};
     }
@@ -161,7 +186,7 @@ EnvEntry f_append(span<EnvEntry> args)
                 p = get<VarCons>(*last).c;
             else p = last;
         } else {
-            valt_or_fail<VarCons, VarList>(args, i, "append");
+            valt_or_fail<VarCons, VarList, VarView>(args, i, "append");
             p = to_cons_copy(*args[i], cons_last);
         }
         if (q) q->d = p;
@@ -189,30 +214,39 @@ EnvEntry f_append(span<EnvEntry> args)
         cerr << "P (v) " << get<EnvEntry>(p).get() << endl;
     }
     */
-    return make_shared<Var>(VarCons{r});
+    return make_var(VarCons{r});
 }
 
 EnvEntry f_set_carj(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("set-car! argc");
-    valt_or_fail<VarCons, VarList, VarNonlist>(args, 0, "set-car!");
+    valt_or_fail<VarCons, VarList, VarNonlist, VarView>(args, 0, "set-car!");
     keeps(args[1]);
+    view_sync(*args[0]);
     if (valt_in<VarCons>(*args[0])) {
         get<VarCons>(*args[0]).c->a = args[1];
+        gc_candidate(get<VarCons>(*args[0]).c);
     } else if (valt_in<VarList>(*args[0])) {
         get<VarList>(*args[0]).v[0] = args[1];
+        gc_candidate(args[0]);
+    } else if (valt_in<VarView>(*args[0])) {
+        auto & w = get<VarView>(*args[0]);
+        w.s->v[w.i] = args[1];
+        gc_candidate(w.s);
     } else {
-        get<VarList>(*args[0]).v[0] = args[1];
+        get<VarNonlist>(*args[0]).v[0] = args[1];
+        gc_candidate(args[0]);
     }
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_set_cdrj(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("set-cdr! argc");
-    valt_or_fail<VarCons, VarList, VarNonlist>(args, 0, "set-cdr!");
+    valt_or_fail<VarCons, VarList, VarNonlist, VarView>(args, 0, "set-cdr!");
     keeps(args[1]);
-    if (valt_in<VarList>(*args[1])) {
+    unview(*args[0]);
+    if (valt_in<VarList, VarView>(*args[1])) {
         auto c = to_cons(*args[1]);
         *args[1] = VarCons{c};
     } else if (valt_in<VarNonlist>(*args[1])) {
@@ -224,22 +258,33 @@ EnvEntry f_set_cdrj(span<EnvEntry> args)
             : ConsNext{args[1]};
     if (valt_in<VarCons>(*args[0])) {
         get<VarCons>(*args[0]).c->d = d;
-        return make_shared<Var>(VarVoid{});
+    } else {
+        EnvEntry a;
+        if (valt_in<VarList>(*args[0])) a = get<VarList>(*args[0]).v[0];
+        else if (valt_in<VarNonlist>(*args[0])) a = get<VarNonlist>(*args[0]).v[0];
+        else a = args[0];
+        *args[0] = VarCons{ make_cons(a, d) };
     }
-    EnvEntry a;
-    if (valt_in<VarList>(*args[0])) a = get<VarList>(*args[0]).v[0];
-    else if (valt_in<VarNonlist>(*args[0])) a = get<VarNonlist>(*args[0]).v[0];
-    else a = args[0];
-    *args[0] = VarCons{ make_shared<Cons>(a, d) };
-    return make_shared<Var>(VarVoid{});
+    gc_candidate(get<VarCons>(*args[0]).c);
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_list_tail(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("list-tail argc");
-    valt_or_fail<VarCons, VarList>(args, 0, "list-tail");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "list-tail");
     valt_or_fail<VarNum>(args, 1, "list-tail");
     auto n = get<VarNum>(*args[1]).i;
+    to_view(*args[0]);
+    view_sync(*args[0]);
+    if (valt_in<VarView>(*args[0])) {
+        auto w = get<VarView>(*args[0]);
+        if (n == 0) return make_var(w);
+        if (w.s->size() - w.i < static_cast<size_t>(n))
+            throw RunError("list-tail overrun");
+        w.i += n - 1;
+        return view_cdr(w);
+    }
     ConsNext r = to_cons(*args[0]);
     *args[0] = VarCons{get<ConsPtr>(r)};
     for (auto i = 0u; i != n; ++i) {
@@ -249,24 +294,35 @@ EnvEntry f_list_tail(span<EnvEntry> args)
         }
         r = get<ConsPtr>(r)->d;
     }
-    return make_shared<Var>(VarCons{get<ConsPtr>(r)});
+    return make_var(VarCons{get<ConsPtr>(r)});
 }
 
 EnvEntry f_list_setj(span<EnvEntry> args)
 {
     if (args.size() != 3) throw RunError("list-set! argc");
-    valt_or_fail<VarCons, VarList>(args, 0, "list-set!");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "list-set!");
     valt_or_fail<VarNum>(args, 1, "list-set!");
     auto n = get<VarNum>(*args[1]).i;
+    view_sync(*args[0]);
     if (valt_in<VarList>(*args[0])) {
         get<VarList>(*args[0]).v[n] = args[2];
+        gc_candidate(args[0]);
+    } else if (valt_in<VarView>(*args[0])) {
+        auto & w = get<VarView>(*args[0]);
+        if (w.s->size() - w.i <= static_cast<size_t>(n))
+            throw RunError("list-set! index overflow");
+        w.s->v[w.i + n] = args[2];
+        gc_candidate(w.s);
     } else {
         vector<EnvEntry> a{args[0], args[1]};
         auto k = f_list_tail(a);
         auto c = get<VarCons>(*k).c;
-        if (c) c->a = args[2];
+        if (c) {
+            c->a = args[2];
+            gc_candidate(c);
+        }
     }
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_make_list(span<EnvEntry> args)
@@ -276,18 +332,18 @@ EnvEntry f_make_list(span<EnvEntry> args)
     auto n = get<VarNum>(*args[0]).i;
     EnvEntry x;
     if (args.size() == 2) x = args[1];
-    else x = make_shared<Var>(VarVoid{});
+    else x = make_var(VarVoid{});
     vector<EnvEntry> v;
     v.reserve(n);
     for (auto i = 0u; i != n; ++i)
         v.push_back(x);
-    return make_shared<Var>(VarList{move(v)});
+    return make_var(VarList{move(v)});
 }
 
 EnvEntry f_reverse(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("reverse argc");
-    valt_or_fail<VarCons, VarList>(args, 0, "reverse");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "reverse");
     auto r = f_list_copy(args);
     auto & a = get<VarList>(*r);
     auto n = a.v.size();
@@ -301,28 +357,38 @@ EnvEntry f_take(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("take argc");
     valt_or_fail<VarNum>(args, 0, "take");
-    valt_or_fail<VarCons, VarList>(args, 1, "take");
+    valt_or_fail<VarCons, VarList, VarView>(args, 1, "take");
     auto n = get<VarNum>(*args[0]).i;
-    if (valt_in<VarList>(*args[1])) {
-        auto & a = get<VarList>(*args[1]).v;
+    if (n == 0) return make_var(VarCons{});
+    view_sync(*args[1]);
+    if (valt_in<VarList, VarView>(*args[1])) {
+        span<EnvEntry> a;
+        if (valt_in<VarList>(*args[1])) {
+            a = get<VarList>(*args[1]).v;
+        } else {
+            auto & w = get<VarView>(*args[1]);
+            a = span<EnvEntry>{w.s->v}.subspan(w.i, w.s->size() - w.i);
+        }
+        if (a.size() < static_cast<size_t>(n))
+            throw RunError("take overrun");
         vector<EnvEntry> r;
         r.reserve(n);
         for (auto i = 0u; i != n; ++i)
             r.push_back(a[i]);
-        return make_shared<Var>(VarList{move(r)});
+        return make_var(VarList{move(r)});
     }
     if (n == 0 or get<VarCons>(*args[1]).c == nullptr)
-        return make_shared<Var>(VarCons{});
+        return make_var(VarCons{});
     ConsPtr ign_last;
-    return make_shared<Var>(
+    return make_var(
             get<VarCons>(*args[1]).c->xcopy(n, ign_last));
 }
 
 EnvEntry f_splice(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("splice argc");
-    valt_or_fail<VarCons, VarList>(args, 0, "splice");
-    return make_shared<Var>(VarSplice{normal_list(*args[0]).v});
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "splice");
+    return make_var(VarSplice{normal_list(*args[0]).v});
 }
 
 //
@@ -332,7 +398,7 @@ EnvEntry f_splice(span<EnvEntry> args)
 EnvEntry f_not(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("not argc");
-    return make_shared<Var>(VarBool{
+    return make_var(VarBool{
             valt_in<VarBool>(*args[0])
             and get<VarBool>(*args[0]).b == false});
 }
@@ -348,7 +414,7 @@ EnvEntry f_pluss(span<EnvEntry> args)
         valt_or_fail<VarNum>(args, i, "+");
         r += get<VarNum>(*args[i]).i;
     }
-    return make_shared<Var>(VarNum{ r });
+    return make_var(VarNum{ r });
 }
 
 EnvEntry f_minus(span<EnvEntry> args)
@@ -356,14 +422,14 @@ EnvEntry f_minus(span<EnvEntry> args)
     valt_or_fail<VarNum>(args, 0, "-");
     auto r = get<VarNum>(*args[0]).i ;
     if (args.size() == 1)
-        return make_shared<Var>(VarNum{ -r });
+        return make_var(VarNum{ -r });
     int i{};
     for (auto & a : args) {
         if (&a == &args[0]) continue;
         valt_or_fail<VarNum>(args, ++i, "-");
         r -= get<VarNum>(*a).i;
     }
-    return make_shared<Var>(VarNum{ r });
+    return make_var(VarNum{ r });
 }
 
 EnvEntry f_multiply(span<EnvEntry> args)
@@ -374,7 +440,7 @@ EnvEntry f_multiply(span<EnvEntry> args)
         valt_or_fail<VarNum>(args, i++, "*");
         r *= get<VarNum>(*x).i;
     }
-    return make_shared<Var>(VarNum{ r });
+    return make_var(VarNum{ r });
 }
 
 pair<long long, long long> rdiv(span<EnvEntry> args, const string & fn)
@@ -395,15 +461,15 @@ pair<long long, long long> rdiv(span<EnvEntry> args, const string & fn)
 EnvEntry f_divide(span<EnvEntry> args)
 {
     auto [n, d] = rdiv(args, "/");
-    return make_shared<Var>(VarNum{ n / d });
+    return make_var(VarNum{ n / d });
 }
 
 EnvEntry f_div(span<EnvEntry> args)
 {
     auto [n, d] = rdiv(args, "div");
-    return make_shared<Var>(VarNonlist{{
-            make_shared<Var>(VarNum{ n / d }),
-            make_shared<Var>(VarNum{ n % d })}});
+    return make_var(VarNonlist{{
+            make_var(VarNum{ n / d }),
+            make_var(VarNum{ n % d })}});
 }
 
 typedef void (*isubj_t)(long long & i, long long j);
@@ -420,7 +486,7 @@ EnvEntry fold_isubj(span<EnvEntry> args, const string & fn, isubj_t f)
         valt_or_fail<VarNum>(args, ++i, fn);
         f(r, get<VarNum>(*x).i);
     }
-    return make_shared<Var>(VarNum{ r });
+    return make_var(VarNum{ r });
 }
 
 EnvEntry f_max(span<EnvEntry> args)
@@ -437,14 +503,14 @@ EnvEntry f_abs(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("abs argc");
     valt_or_fail<VarNum>(args, 0, "abs");
-    return make_shared<Var>(VarNum{abs(get<VarNum>(*args[0]).i)});
+    return make_var(VarNum{abs(get<VarNum>(*args[0]).i)});
 }
 
 EnvEntry n1_pred(span<EnvEntry> args, string fn, bool(*p)(long long))
 {
     if (args.size() != 1) throw RunError(fn + "argc");
     valt_or_fail<VarNum>(args, 0, fn);
-    return make_shared<Var>(VarBool{ p(get<VarNum>(*args[0]).i) });
+    return make_var(VarBool{ p(get<VarNum>(*args[0]).i) });
 }
 
 bool is_zero(long long i) { return i == 0; }
@@ -470,7 +536,7 @@ EnvEntry f_oddp(span<EnvEntry> args)
 EnvEntry n2_pred(span<EnvEntry> args, string fn,
         bool(*p)(long long, long long))
 {
-    auto r = make_shared<Var>(VarBool{ true });
+    auto r = make_var(VarBool{ true });
     if (args.size() == 0) return r;
     valt_or_fail<VarNum>(args, 0, fn);
     if (args.size() == 1) {
@@ -520,36 +586,40 @@ EnvEntry setjj(span<EnvEntry> args)
     if (&*args[0] == &*args[1]) {
         warn("self-set", args);
     } else {
-        if (valt_in<VarList, VarNonlist>(*args[1])) {
+        if (valt_in<VarList, VarNonlist, VarView>(*args[1])) {
             auto c = to_cons(*args[1]);
             *args[1] = VarCons{c};
         }
         visit([&args](auto && w) { *args[0] = w; }, *args[1]);
     }
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_setj(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("set! argc");
-    if (not ((valt_in<VarCons, VarList, VarNonlist>(*args[0])
-                    and valt_in<VarCons, VarList, VarNonlist>(*args[1]))
+    if (not ((valt_in<VarCons, VarList, VarNonlist, VarView>(*args[0])
+                    and valt_in<VarCons, VarList, VarNonlist, VarView>(*args[1]))
                 or args[0]->index() == args[1]->index())) {
         warn("set! to different type", args);
     }
-    return setjj(args);
+    auto r = setjj(args);
+    gc_candidate(args[0]);
+    return r;
 }
 
 EnvEntry f_setjj(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("set!! argc");
-    return setjj(args);
+    auto r = setjj(args);
+    gc_candidate(args[0]);
+    return r;
 }
 
 EnvEntry f_dup(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("dup argc");
-    auto r = make_shared<Var>(VarVoid{});
+    auto r = make_var(VarVoid{});
     if (valt_in<VarVoid>(*args[0])) {
         warn("dup of void", args);
         return args[0];
@@ -564,6 +634,59 @@ EnvEntry f_dup(span<EnvEntry> args)
     return r;
 }
 
+EnvEntry f_gc(span<EnvEntry> args)
+{
+    if (args.size() != 0) throw RunError("gc argc");
+    return make_var(VarNum{static_cast<long long>(gc_collect())});
+}
+
+EnvEntry f_gc_threshold(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("gc-threshold argc");
+    valt_or_fail<VarNum>(args, 0, "gc-threshold");
+    auto n = get<VarNum>(*args[0]).i;
+    if (n < 0) throw RunError("gc-threshold negative");
+    return make_var(VarNum{static_cast<long long>(gc_threshold(n))});
+}
+
+// note: of this thread and those ended, so not of the pool workers,
+//       and vars by type as made, as one may change type in place.
+EnvEntry f_heap_stats(span<EnvEntry> args)
+{
+    if (args.size() != 0) throw RunError("heap-stats argc");
+    auto c = heap_stats();
+    vector<EnvEntry> r;
+    auto add = [&r](const string & s, long long i) {
+        vector<EnvEntry> p{make_var(VarNam{u_names->intern(s)}),
+                make_var(VarNum{i})};
+        r.push_back(make_var(VarNonlist{move(p)}));
+    };
+    for (int k = 0; k != HEAP_KINDS; ++k) {
+        string s = heap_kind_name(k);
+        add(s + "-made", c.made[k]);
+        add(s + "-live", c.made[k] - c.freed[k]);
+    }
+    add("bytes", c.bytes);
+    add("peak-bytes", c.peak);
+    add("pool-bytes", c.pool_bytes);
+    for (size_t i = 0; i != variant_size_v<Var>; ++i)
+        if (c.var_made[i])
+            add(string("made-") + var_type_name(i), c.var_made[i]);
+    return make_var(VarList{move(r)});
+}
+
+EnvEntry f_trace_dump(span<EnvEntry> args)
+{
+    if (args.size() > 1) throw RunError("trace-dump argc");
+    string fn;
+    if (args.size() == 1) {
+        valt_or_fail<VarString>(args, 0, "trace-dump");
+        fn = get<VarString>(*args[0]).s;
+    }
+    trace_dump(fn);
+    return make_var(VarVoid{});
+}
+
 //
 // identity
 //
@@ -571,16 +694,15 @@ EnvEntry f_dup(span<EnvEntry> args)
 EnvEntry f_aliasp(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("alias? argc");
-    return make_shared<Var>(VarBool{&*args[0] == &*args[1]});
+    return make_var(VarBool{&*args[0] == &*args[1]});
 }
 
-EnvEntry f_eqp(span<EnvEntry> args)
+bool is_eqv(Var & a, Var & b)
 {
-    if (args.size() != 2) throw RunError("eq? argc");
-    Var & a = *args[0];
-    Var & b = *args[1];
+    view_sync(a);
+    view_sync(b);
     bool r{};
-    if (args[0]->index() != args[1]->index()) {
+    if (a.index() != b.index()) {
         // false.  different types
     } else if (valt_in<VarNum>(a)) {
         r = (get<VarNum>(a).i == get<VarNum>(b).i);
@@ -592,97 +714,149 @@ EnvEntry f_eqp(span<EnvEntry> args)
         r = (get<VarNam>(a).h == get<VarNam>(b).h);
     } else if (valt_in<VarCons>(a)) {
         r = (get<VarCons>(a).c == get<VarCons>(b).c);
+    } else if (valt_in<VarView>(a)) {
+        auto & v = get<VarView>(a);
+        auto & w = get<VarView>(b);
+        r = (v.s == w.s and v.i == w.i);
     } else {
         r = (&a == &b);
     }
-    return make_shared<Var>(VarBool{r});
+    return r;
 }
 
-EnvEntry f_equalp(span<EnvEntry> args)
+EnvEntry f_eqp(span<EnvEntry> args)
 {
-    if (args.size() != 2) throw RunError("equal? argc");
-    Var & a = *args[0];
-    Var & b = *args[1];
-    if (not valt_in<VarList, VarNonlist, VarCons>(a)
-            or not valt_in<VarList, VarNonlist, VarCons>(b))
-        return f_eqp(args);
-    auto r = make_shared<Var>(VarBool{});
-    if ((valt_in<VarList>(a) and valt_in<VarList>(b))
-            or (valt_in<VarNonlist>(a) and valt_in<VarNonlist>(b))) {
-        vector<EnvEntry> * x{};
-        vector<EnvEntry> * y{};
-        if (valt_in<VarList>(a)) {
-            x = &get<VarList>(a).v;
-            y = &get<VarList>(b).v;
+    if (args.size() != 2) throw RunError("eq? argc");
+    return make_var(VarBool{is_eqv(*args[0], *args[1])});
+}
+
+// Cursor over the elements of a list, nonlist, cons or record,
+// where a dot tail comes as a step of its own after the elements
+// so that the storage used for equal lists does not matter.
+struct EqualWalk {
+    enum { END, ELEM, TAIL };
+    EnvEntry * v;
+    size_t n;
+    Cons * c;
+    Var * tail;
+    EqualWalk(Var & x) : v{}, n{}, c{}, tail{}
+    {
+        if (holds_alternative<VarList>(x)) {
+            auto & w = get<VarList>(x).v;
+            v = w.data();
+            n = w.size();
+        } else if (holds_alternative<VarNonlist>(x)) {
+            auto & w = get<VarNonlist>(x).v;
+            v = w.data();
+            n = w.size() - 1;
+            tail = &*w.back();
+        } else if (holds_alternative<VarRec>(x)) {
+            auto & w = get<VarRec>(x).v;
+            v = w.data();
+            n = w.size();
+        } else if (holds_alternative<VarView>(x)) {
+            auto & w = get<VarView>(x);
+            auto & s = *w.s;
+            if (not s.cells.empty()) {
+                c = s.cells[w.i].get();
+            } else {
+                v = s.v.data() + w.i;
+                n = s.size() - w.i;
+                if (s.dot) tail = &*s.v.back();
+            }
         } else {
-            x = &get<VarNonlist>(a).v;
-            y = &get<VarNonlist>(b).v;
-        }
-        if (x->size() != y->size()) return r;
-        for (size_t i{}; i != x->size(); ++i) {
-            vector<EnvEntry> q{(*x)[i], (*y)[i]};
-            auto e = f_equalp(q);
-            if (not get<VarBool>(*e).b) return e;
+            c = get<VarCons>(x).c.get();
         }
-        get<VarBool>(*r).b = true;
-        return r;
     }
-    if (valt_in<VarCons>(a) and valt_in<VarCons>(b)) {
-        ConsNext x = get<VarCons>(a).c;
-        ConsNext y = get<VarCons>(b).c;
-        for (;;) {
-            if (not holds_alternative<ConsPtr>(x)) {
-                if (holds_alternative<ConsPtr>(y)) return r;
-                vector<EnvEntry> q{get<EnvEntry>(x), get<EnvEntry>(y)};
-                return f_equalp(q);
+    int next(Var *& x)
+    {
+        if (n) {
+            --n;
+            x = &**v++;
+            return ELEM;
+        }
+        if (c) {
+            x = &*c->a;
+            if (holds_alternative<ConsPtr>(c->d)) {
+                c = get<ConsPtr>(c->d).get();
+            } else {
+                tail = &*get<EnvEntry>(c->d);
+                c = nullptr;
             }
-            if (nullptr == get<ConsPtr>(x)) break;
-            if (not holds_alternative<ConsPtr>(y) or nullptr == get<ConsPtr>(y))
-                return r;
-            vector<EnvEntry> q{get<ConsPtr>(x)->a, get<ConsPtr>(y)->a};
-            auto e = f_equalp(q);
-            if (not get<VarBool>(*e).b) return e;
-            x = get<ConsPtr>(x)->d;
-            y = get<ConsPtr>(y)->d;
+            return ELEM;
         }
-        get<VarBool>(*r).b = nullptr == get<ConsPtr>(y);
-        return r;
+        if (tail) {
+            x = tail;
+            tail = nullptr;
+            return TAIL;
+        }
+        return END;
     }
-    if (valt_in<VarCons>(a) or valt_in<VarCons>(b)) {
-        bool is_nonlist{};
-        vector<EnvEntry> * v;
-        ConsNext c;
-        if (valt_in<VarCons>(b)) {
-            v = (is_nonlist = valt_in<VarNonlist>(a))
-                ? &get<VarNonlist>(a).v : &get<VarList>(a).v;
-            c = get<VarCons>(b).c;
-        } else {
-            v = (is_nonlist = valt_in<VarNonlist>(b))
-                ? &get<VarNonlist>(b).v : &get<VarList>(b).v;
-            c = get<VarCons>(a).c;
+};
+
+thread_local vector<pair<EqualWalk, EqualWalk>> equal_stack;
+
+// note: after this many steps the pairs compared are kept, so that
+//       a pair met again is taken as equal, and cycles end.
+constexpr size_t EQUAL_STEPS = 1 << 16;
+thread_local set<pair<const void *, const void *>> equal_seen;
+
+// note: false when a and b differ, and when they have elements to
+//       compare a step is pushed for these.
+bool equal_push(Var & a, Var & b, bool seen)
+{
+    if (&a == &b) return true;
+    bool j = valt_in<VarList, VarNonlist, VarCons, VarView>(a);
+    bool k = valt_in<VarList, VarNonlist, VarCons, VarView>(b);
+    if (j or k) {
+        if (not (j and k)) return false;
+        if (valt_in<VarCons>(a) and valt_in<VarCons>(b)
+                and get<VarCons>(a).c == get<VarCons>(b).c)
+            return true;
+    } else if (valt_in<VarRec>(a) or valt_in<VarRec>(b)) {
+        if (a.index() != b.index()
+                or get<VarRec>(a).v.size() != get<VarRec>(b).v.size())
+            return false;
+    } else {
+        return is_eqv(a, b);
+    }
+    if (seen and not equal_seen.emplace(&a, &b).second)
+        return true;
+    equal_stack.emplace_back(a, b);
+    return true;
+}
+
+bool is_equal(Var & a, Var & b)
+{
+    equal_stack.clear();
+    equal_seen.clear();
+    size_t steps = 0;
+    if (not equal_push(a, b, false)) return false;
+    while (not equal_stack.empty()) {
+        auto & f = equal_stack.back();
+        bool seen = ++steps > EQUAL_STEPS;
+        if (seen and f.first.c and f.second.c
+                and not equal_seen.emplace(f.first.c, f.second.c).second) {
+            equal_stack.pop_back();
+            continue;
         }
-        size_t n = v->size();
-        size_t i{};
-        while (not holds_alternative<ConsPtr>(c) or get<ConsPtr>(c)) {
-            if (i == n) return r;
-            if (not holds_alternative<ConsPtr>(c)) {
-                if (not is_nonlist or i + 1 != n)
-                    return r;
-                vector<EnvEntry> q{get<EnvEntry>(c), (*v)[i]};
-                return f_equalp(q);
-            }
-            auto k = get<ConsPtr>(c);
-            vector<EnvEntry> q{k->a, (*v)[i]};
-            auto e = f_equalp(q);
-            if (not get<VarBool>(*e).b) return e;
-            c = k->d;
-            ++i;
+        Var * x;
+        Var * y;
+        int i = f.first.next(x);
+        if (i != f.second.next(y)) return false;
+        if (i == EqualWalk::END) {
+            equal_stack.pop_back();
+            continue;
         }
-        get<VarBool>(*r).b = i == n;
-        return r;
+        if (not equal_push(*x, *y, seen)) return false;
     }
-    warn("list-nonlist compare", args);
-    return r;
+    return true;
+}
+
+EnvEntry f_equalp(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("equal? argc");
+    return make_var(VarBool{is_equal(*args[0], *args[1])});
 }
 
 //
@@ -694,7 +868,7 @@ EnvEntry f_make_record(span<EnvEntry> args)
     if (args.size() < 1) throw RunError("make-record argc");
     valt_or_fail<VarNam>(args, 0, "make-record");
     vector<EnvEntry> v{args.begin(), args.end()};
-    return make_shared<Var>(VarRec{v});
+    return make_var(VarRec{v});
 }
 
 EnvEntry f_record_get(span<EnvEntry> args)
@@ -714,7 +888,8 @@ EnvEntry f_record_setj(span<EnvEntry> args)
     keeps(args[2]);
     auto & r = get<VarRec>(*args[0]);
     r.v[get<VarNum>(*args[1]).i + 1] = args[2];
-    return make_shared<Var>(VarVoid{});
+    gc_candidate(args[0]);
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_recordp(span<EnvEntry> args)
@@ -723,7 +898,7 @@ EnvEntry f_recordp(span<EnvEntry> args)
     valt_or_fail<VarRec>(args, 0, "record?");
     valt_or_fail<VarNam>(args, 1, "record?");
     auto h = get<VarNam>(*get<VarRec>(*args[0]).v[0]).h;
-    return make_shared<Var>(VarBool{get<VarNam>(*args[1]).h == h});
+    return make_var(VarBool{get<VarNam>(*args[1]).h == h});
 }
 
 //
@@ -735,34 +910,34 @@ EnvEntry f_string_ref(span<EnvEntry> args)
     if (args.size() != 2) throw RunError("string->ref argc");
     valt_or_fail<VarString>(args, 0, "string->ref");
     valt_or_fail<VarNum>(args, 1, "string->ref");
-    auto s = get<VarString>(*args[0]).s;
+    auto & v = get<VarString>(*args[0]);
     auto i = get<VarNum>(*args[1]).i;
-    auto w = utf_ref(s, i);
-    long long r{};
-    if (not w.u.empty())
-        r = utf_value(w);
-    return make_shared<Var>(VarNum{r});
+    auto & x = utf_index(v);
+    if (i < 0 or static_cast<size_t>(i) >= x.count)
+        throw RunError("string-ref index overflow");
+    string_view s = v.s;
+    auto w = utf_ref(s.substr(x.offset(s, i)), 0);
+    return make_var(VarNum{utf_value(w)});
 }
 
 EnvEntry f_string_z_list(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("string->list argc");
     valt_or_fail<VarString>(args, 0, "string->list");
-    auto s = get<VarString>(*args[0]).s;
+    string_view s = get<VarString>(*args[0]).s;
     vector<EnvEntry> v;
-    for (int i = 0 ;; ++i) {
-        auto w = utf_ref(s, i);
-        if (w.u.empty()) break;
-        auto c = utf_value(w);
-        v.push_back(make_shared<Var>(VarNum{c}));
+    while (not s.empty()) {
+        auto w = utf_ref(s, 0);
+        v.push_back(make_var(VarNum{utf_value(w)}));
+        s.remove_prefix(w.u.size());
     }
-    return make_shared<Var>(VarList{move(v)});
+    return make_var(VarList{move(v)});
 }
 
 EnvEntry f_list_z_string(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("list->string argc");
-    valt_or_fail<VarCons, VarList>(args, 0, "list->string");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "list->string");
     auto j = make_iter(*args[0]);
     string s;
     for (;;) {
@@ -772,7 +947,8 @@ EnvEntry f_list_z_string(span<EnvEntry> args)
             throw RunError("list->string not number");
         s += utf_make(get<VarNum>(*x).i);
     }
-    return make_shared<Var>(VarString{move(s)});
+    if (not utf_valid(s)) throw RunError("list->string not utf8");
+    return make_var(VarString{move(s)});
 }
 
 EnvEntry f_symbol_z_string(span<EnvEntry> args)
@@ -780,53 +956,283 @@ EnvEntry f_symbol_z_string(span<EnvEntry> args)
     if (args.size() != 1) throw RunError("symbol->string argc");
     valt_or_fail<VarNam>(args, 0, "symbol->string");
     int h = get<VarNam>(*args[0]).h;
-    return make_shared<Var>(VarString{u_names->get(h)});
+    return make_var(VarString{u_names->get(h)});
 }
 
+// note: indices are of code points, and as for string-ref the
+//       string index is made at first use and kept with it.
 EnvEntry f_substring(span<EnvEntry> args)
 {
     if (args.size() < 2) throw RunError("substring argc");
     valt_or_fail<VarString>(args, 0, "substring");
     valt_or_fail<VarNum>(args, 1, "substring");
-    auto & s = get<VarString>(*args[0]).s;
-    size_t i = get<VarNum>(*args[1]).i;
-    auto j = s.npos;
+    auto & v = get<VarString>(*args[0]);
+    auto & x = utf_index(v);
+    auto clamp = [&x](long long k) -> size_t {
+        return k < 0 ? 0 : min(static_cast<size_t>(k), x.count);
+    };
+    size_t i = clamp(get<VarNum>(*args[1]).i);
+    size_t j = x.count;
     if (args.size() >= 3) {
         valt_or_fail<VarNum>(args, 2, "substring");
-        j = get<VarNum>(*args[2]).i;
+        j = clamp(get<VarNum>(*args[2]).i);
         if (j < i) j = i;
     }
-    return make_shared<Var>(VarString{s.substr(i, j - i)});
+    string_view s = v.s;
+    size_t a = x.offset(s, i);
+    size_t b = x.offset(s, j);
+    return make_var(VarString{string{s.substr(a, b - a)}});
+}
+
+int t_string_pattern;
+
+void delete_pattern(void * u)
+{
+    delete static_cast<Pattern *>(u);
+}
+
+EnvEntry f_make_string_pattern(span<EnvEntry> args)
+{
+    if (args.empty()) throw RunError("make-string-pattern argc");
+    vector<string> u;
+    for (size_t i = 0; i != args.size(); ++i) {
+        valt_or_fail<VarString>(args, i, "make-string-pattern");
+        u.push_back(get<VarString>(*args[i]).s);
+        if (u.back().empty())
+            throw RunError("make-string-pattern empty needle");
+    }
+    auto r = VarExt{t_string_pattern};
+    r.u = make_pattern(move(u)).release();
+    r.f = delete_pattern;
+    return make_var(move(r));
+}
+
+EnvEntry f_string_patternp(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("string-pattern? argc");
+    return make_var(VarBool{
+            holds_alternative<VarExt>(*args[0])
+            and get<VarExt>(*args[0]).t == t_string_pattern});
+}
+
+// note: the start is taken in code points and the byte offset
+//       of it returned, with the code points before it in c.  a
+//       string needle is searched for as is, as compiling it would
+//       not pay off for one search.
+size_t search_args(span<EnvEntry> args, const string & fn, long long & c)
+{
+    if (args.size() != 2 and args.size() != 3) throw RunError(fn + " argc");
+    valt_or_fail<VarString>(args, 0, fn);
+    if (holds_alternative<VarExt>(*args[1]))
+        vext_or_fail({t_string_pattern}, args, 1, fn);
+    else
+        valt_or_fail<VarString>(args, 1, fn);
+    c = 0;
+    if (args.size() == 2) return 0;
+    valt_or_fail<VarNum>(args, 2, fn);
+    auto i = get<VarNum>(*args[2]).i;
+    if (i <= 0) return 0;
+    auto & v = get<VarString>(*args[0]);
+    auto & x = utf_index(v);
+    c = min<long long>(i, x.count);
+    return x.offset(v.s, i);
+}
+
+bool search_next(Var & u, string_view s, size_t from, SearchMatch & m)
+{
+    if (holds_alternative<VarExt>(u))
+        return static_cast<Pattern *>(get<VarExt>(u).u)->find(s, from, m);
+    auto & t = get<VarString>(u).s;
+    auto i = s.find(t, from);
+    if (i == s.npos) return false;
+    m = {i, t.size(), 0};
+    return true;
 }
 
 EnvEntry f_substring_index(span<EnvEntry> args)
 {
-    if (args.size() != 2) throw RunError("substring-index argc");
-    valt_or_fail<VarString>(args, 0, "substring-index");
-    valt_or_fail<VarString>(args, 1, "substring-index");
-    auto s = get<VarString>(*args[0]).s;
-    auto t = get<VarString>(*args[1]).s;
-    auto i = s.find(t);
-    long long r = i == s.npos ? -1 : i;
-    return make_shared<Var>(VarNum{r});
+    long long c;
+    size_t from = search_args(args, "substring-index", c);
+    string_view s = get<VarString>(*args[0]).s;
+    SearchMatch m;
+    long long r = -1;
+    if (search_next(*args[1], s, from, m))
+        r = c + utf_count(s.substr(from, m.at - from));
+    return make_var(VarNum{r});
+}
+
+EnvEntry f_string_search_all(span<EnvEntry> args)
+{
+    long long c;
+    size_t from = search_args(args, "string-search-all", c);
+    string_view s = get<VarString>(*args[0]).s;
+    if (holds_alternative<VarString>(*args[1])
+            and get<VarString>(*args[1]).s.empty())
+        throw RunError("string-search-all empty needle");
+    vector<EnvEntry> r;
+    SearchMatch m;
+    size_t at = from;  // with c code points before it
+    while (search_next(*args[1], s, from, m)) {
+        c += utf_count(s.substr(at, m.at - at));
+        at = m.at;
+        r.push_back(make_var(VarNum{c}));
+        from = m.at + m.n;
+    }
+    return list_or_empty(move(r));
+}
+
+int t_regex;
+
+void delete_regex(void * u)
+{
+    delete static_cast<Regex *>(u);
+}
+
+// note: copied, as the dfa is cached in it as it is used
+void * regex_transfer(void * u, Transfer &)
+{
+    return new Regex(*static_cast<Regex *>(u));
+}
+
+// note: a string is compiled for the one call
+Regex & regex_or_fail(span<EnvEntry> args, const string & fn,
+        unique_ptr<Regex> & own)
+{
+    if (holds_alternative<VarString>(*args[0])) {
+        own = make_unique<Regex>(get<VarString>(*args[0]).s);
+        return *own;
+    }
+    auto & e = vext_or_fail({t_regex}, args, 0, fn);
+    return *static_cast<Regex *>(e.u);
+}
+
+EnvEntry f_regex_compile(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("regex-compile argc");
+    valt_or_fail<VarString>(args, 0, "regex-compile");
+    auto r = VarExt{t_regex};
+    r.u = new Regex(get<VarString>(*args[0]).s);
+    r.f = delete_regex;
+    return make_var(move(r));
+}
+
+EnvEntry f_regexp(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("regex? argc");
+    return make_var(VarBool{
+            holds_alternative<VarExt>(*args[0])
+            and get<VarExt>(*args[0]).t == t_regex});
+}
+
+EnvEntry f_regex_match(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("regex-match argc");
+    unique_ptr<Regex> own;
+    auto & x = regex_or_fail(args, "regex-match", own);
+    valt_or_fail<VarString>(args, 1, "regex-match");
+    return make_var(VarBool{x.match(get<VarString>(*args[1]).s)});
+}
+
+EnvEntry f_regex_search(span<EnvEntry> args)
+{
+    if (args.size() != 2 and args.size() != 3)
+        throw RunError("regex-search argc");
+    unique_ptr<Regex> own;
+    auto & x = regex_or_fail(args, "regex-search", own);
+    valt_or_fail<VarString>(args, 1, "regex-search");
+    auto & v = get<VarString>(*args[1]);
+    size_t from = 0;
+    if (args.size() == 3) {
+        valt_or_fail<VarNum>(args, 2, "regex-search");
+        auto i = get<VarNum>(*args[2]).i;
+        if (i > 0) from = utf_index(v).offset(v.s, i);
+    }
+    string_view s = v.s;
+    pair<size_t, size_t> m;
+    if (not x.search(s, from, m))
+        return make_var(VarBool{false});
+    long long a = utf_count(s.substr(0, m.first));
+    long long b = a + utf_count(s.substr(m.first, m.second - m.first));
+    return make_var(VarList{{
+            make_var(VarNum{a}), make_var(VarNum{b})}});
+}
+
+// note: an empty match does not split
+EnvEntry f_regex_split(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("regex-split argc");
+    unique_ptr<Regex> own;
+    auto & x = regex_or_fail(args, "regex-split", own);
+    valt_or_fail<VarString>(args, 1, "regex-split");
+    string_view s = get<VarString>(*args[1]).s;
+    vector<EnvEntry> r;
+    size_t at = 0;
+    size_t from = 0;
+    pair<size_t, size_t> m;
+    while (from <= s.size() and x.search(s, from, m)) {
+        if (m.first == m.second) {
+            if (m.first == s.size()) break;
+            from = m.first + utf_ref(s.substr(m.first), 0).u.size();
+            continue;
+        }
+        r.push_back(make_var(VarString{
+                    string{s.substr(at, m.first - at)}}));
+        at = from = m.second;
+    }
+    r.push_back(make_var(VarString{string{s.substr(at)}}));
+    return make_var(VarList{move(r)});
+}
+
+// note: as in python, an empty match is replaced too, and the
+//       search goes on past the next code point.
+EnvEntry f_regex_replace(span<EnvEntry> args)
+{
+    if (args.size() != 3) throw RunError("regex-replace argc");
+    unique_ptr<Regex> own;
+    auto & x = regex_or_fail(args, "regex-replace", own);
+    valt_or_fail<VarString>(args, 1, "regex-replace");
+    valt_or_fail<VarString>(args, 2, "regex-replace");
+    string_view s = get<VarString>(*args[1]).s;
+    auto & t = get<VarString>(*args[2]).s;
+    string r;
+    size_t at = 0;
+    pair<size_t, size_t> m;
+    while (at <= s.size() and x.search(s, at, m)) {
+        r += s.substr(at, m.first - at);
+        r += t;
+        at = m.second;
+        if (m.first == m.second) {
+            if (at == s.size()) break;
+            size_t k = utf_ref(s.substr(at), 0).u.size();
+            r += s.substr(at, k);
+            at += k;
+        }
+    }
+    if (at < s.size()) r += s.substr(at);
+    return make_var(VarString{move(r)});
 }
 
 EnvEntry f_string_length(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("string-length argc");
     valt_or_fail<VarString>(args, 0, "string-length");
-    auto s = get<VarString>(*args[0]).s;
-    return make_shared<Var>(VarNum{static_cast<long long>(s.length())});
+    auto & v = get<VarString>(*args[0]);
+    size_t n = v.x.p ? v.x.p->count : utf_count(v.s);
+    return make_var(VarNum{static_cast<long long>(n)});
 }
 
 EnvEntry f_string_append(span<EnvEntry> args)
 {
+    size_t n{};
+    for (size_t i = 0; i != args.size(); ++i) {
+        valt_or_fail<VarString>(args, i, "string-append");
+        n += get<VarString>(*args[i]).s.size();
+    }
     string r;
-    for (auto & a : args) {
-        valt_or_fail<VarString>(args, 0, "string-length");
+    r.reserve(n);
+    for (auto & a : args)
         r += get<VarString>(*a).s;
-    }
-    return make_shared<Var>(VarString{r});
+    return make_var(VarString{move(r)});
 }
 
 typedef bool (*spred_t)(const string &, const string &);
@@ -835,9 +1241,9 @@ EnvEntry spred(span<EnvEntry> args, const string & fn, spred_t f)
     if (args.size() != 2) throw RunError(fn);
     valt_or_fail<VarString>(args, 0, fn);
     valt_or_fail<VarString>(args, 1, fn);
-    auto s = get<VarString>(*args[0]).s;
-    auto t = get<VarString>(*args[1]).s;
-    return make_shared<Var>(VarBool{f(s, t)});
+    auto & s = get<VarString>(*args[0]).s;
+    auto & t = get<VarString>(*args[1]).s;
+    return make_var(VarBool{f(s, t)});
 }
 
 bool spred_eqp(const string & s, const string & t) { return s == t; }
@@ -858,6 +1264,161 @@ EnvEntry f_stringgtp(span<EnvEntry> args)
     return spred(args, "string>?", spred_gtp);
 }
 
+EnvEntry f_string_prefixp(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("string-prefix? argc");
+    valt_or_fail<VarString>(args, 0, "string-prefix?");
+    valt_or_fail<VarString>(args, 1, "string-prefix?");
+    auto & u = get<VarString>(*args[0]).s;
+    auto & s = get<VarString>(*args[1]).s;
+    return make_var(VarBool{s.starts_with(u)});
+}
+
+EnvEntry f_string_suffixp(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("string-suffix? argc");
+    valt_or_fail<VarString>(args, 0, "string-suffix?");
+    valt_or_fail<VarString>(args, 1, "string-suffix?");
+    auto & u = get<VarString>(*args[0]).s;
+    auto & s = get<VarString>(*args[1]).s;
+    return make_var(VarBool{s.ends_with(u)});
+}
+
+constexpr const char * WHITE_SPACE = " \t\n\r\f\v";
+
+// note: with no separator the split is on runs of white-space,
+//       and there is no empty string at either end, as in python.
+EnvEntry f_string_split(span<EnvEntry> args)
+{
+    if (args.size() != 1 and args.size() != 2)
+        throw RunError("string-split argc");
+    valt_or_fail<VarString>(args, 0, "string-split");
+    string_view s = get<VarString>(*args[0]).s;
+    vector<EnvEntry> r;
+    auto add = [&r](string_view x) {
+        r.push_back(make_var(VarString{string{x}}));
+    };
+    if (args.size() == 1) {
+        for (size_t i = s.find_first_not_of(WHITE_SPACE); i != s.npos; ) {
+            size_t j = s.find_first_of(WHITE_SPACE, i);
+            add(s.substr(i, j - i));
+            if (j == s.npos) break;
+            i = s.find_first_not_of(WHITE_SPACE, j);
+        }
+        return list_or_empty(move(r));
+    }
+    valt_or_fail<VarString>(args, 1, "string-split");
+    string_view u = get<VarString>(*args[1]).s;
+    if (u.empty()) throw RunError("string-split empty separator");
+    size_t i = 0;
+    for (size_t j; (j = s.find(u, i)) != s.npos; i = j + u.size())
+        add(s.substr(i, j - i));
+    add(s.substr(i));
+    return list_or_empty(move(r));
+}
+
+EnvEntry f_string_join(span<EnvEntry> args)
+{
+    if (args.size() != 1 and args.size() != 2)
+        throw RunError("string-join argc");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "string-join");
+    string_view u;
+    if (args.size() == 2) {
+        valt_or_fail<VarString>(args, 1, "string-join");
+        u = get<VarString>(*args[1]).s;
+    }
+    string r;
+    auto j = make_iter(*args[0]);
+    bool first = true;
+    while (auto x = j->get()) {
+        if (not valt_in<VarString>(*x))
+            throw RunError("string-join not string");
+        if (not first) r += u;
+        first = false;
+        r += get<VarString>(*x).s;
+    }
+    return make_var(VarString{move(r)});
+}
+
+EnvEntry string_trim(span<EnvEntry> args, const string & fn,
+        bool left, bool right)
+{
+    if (args.size() != 1) throw RunError(fn + " argc");
+    valt_or_fail<VarString>(args, 0, fn);
+    string_view s = get<VarString>(*args[0]).s;
+    if (left) {
+        size_t i = s.find_first_not_of(WHITE_SPACE);
+        s.remove_prefix(i == s.npos ? s.size() : i);
+    }
+    if (right) {
+        size_t i = s.find_last_not_of(WHITE_SPACE);
+        s = s.substr(0, i == s.npos ? 0 : i + 1);
+    }
+    return make_var(VarString{string{s}});
+}
+
+EnvEntry f_string_trim(span<EnvEntry> args)
+{
+    return string_trim(args, "string-trim", true, true);
+}
+
+EnvEntry f_string_trim_left(span<EnvEntry> args)
+{
+    return string_trim(args, "string-trim-left", true, false);
+}
+
+EnvEntry f_string_trim_right(span<EnvEntry> args)
+{
+    return string_trim(args, "string-trim-right", false, true);
+}
+
+// note: the code point is as string-ref gives, and the result is
+//       an index of code points as well, or -1.
+EnvEntry f_string_index(span<EnvEntry> args)
+{
+    if (args.size() != 2 and args.size() != 3)
+        throw RunError("string-index argc");
+    valt_or_fail<VarString>(args, 0, "string-index");
+    valt_or_fail<VarNum>(args, 1, "string-index");
+    auto & v = get<VarString>(*args[0]);
+    string_view s = v.s;
+    size_t from = 0;
+    if (args.size() == 3) {
+        valt_or_fail<VarNum>(args, 2, "string-index");
+        auto i = get<VarNum>(*args[2]).i;
+        if (i > 0) from = utf_index(v).offset(s, i);
+    }
+    auto c = get<VarNum>(*args[1]).i;
+    size_t i = s.npos;
+    if (c >= 0 and c < 0x80)
+        i = s.find(static_cast<char>(c), from);
+    else if (c > 0)
+        i = s.find(utf_make(c), from);
+    long long r = i == s.npos ? -1 : utf_count(s.substr(0, i));
+    return make_var(VarNum{r});
+}
+
+// note: only the ascii letters are mapped
+EnvEntry string_case(span<EnvEntry> args, const string & fn, char a)
+{
+    if (args.size() != 1) throw RunError(fn + " argc");
+    valt_or_fail<VarString>(args, 0, fn);
+    string r = get<VarString>(*args[0]).s;
+    for (auto & c : r)
+        if (a <= c and c < a + 26) c ^= 0x20;
+    return make_var(VarString{move(r)});
+}
+
+EnvEntry f_string_upcase(span<EnvEntry> args)
+{
+    return string_case(args, "string-upcase", 'a');
+}
+
+EnvEntry f_string_downcase(span<EnvEntry> args)
+{
+    return string_case(args, "string-downcase", 'A');
+}
+
 EnvEntry f_string_z_number(span<EnvEntry> args)
 {
     if (args.size() < 1) throw RunError("string->number argc");
@@ -870,7 +1431,7 @@ EnvEntry f_string_z_number(span<EnvEntry> args)
             throw RunError("string->number radix");
     }
     auto r = strtoll(s.data(), nullptr, radix);
-    return make_shared<Var>(VarNum{r});
+    return make_var(VarNum{r});
 }
 
 EnvEntry f_number_z_string(span<EnvEntry> args)
@@ -886,7 +1447,7 @@ EnvEntry f_number_z_string(span<EnvEntry> args)
         oss << setbase(radix);
     }
     oss << n;
-    return make_shared<Var>(VarString{oss.str()});
+    return make_var(VarString{oss.str()});
 }
 
 //
@@ -896,34 +1457,35 @@ EnvEntry f_number_z_string(span<EnvEntry> args)
 EnvEntry f_booleanp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("boolean? argc");
-    return make_shared<Var>(VarBool{valt_in<VarBool>(*args[0])});
+    return make_var(VarBool{valt_in<VarBool>(*args[0])});
 }
 EnvEntry f_numberp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("number? argc");
-    return make_shared<Var>(VarBool{valt_in<VarNum>(*args[0])});
+    return make_var(VarBool{valt_in<VarNum>(*args[0])});
 }
 
 EnvEntry f_procedurep(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("procedure? argc");
-    return make_shared<Var>(VarBool{
+    return make_var(VarBool{
             valt_in<VarFunHost, VarFunOps>(*args[0])});
 }
 
 EnvEntry f_symbolp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("symbol? argc");
-    return make_shared<Var>(VarBool{valt_in<VarNam>(*args[0])});
+    return make_var(VarBool{valt_in<VarNam>(*args[0])});
 }
 
 EnvEntry f_nullp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("null? argc");
     auto & a = *args[0];
+    view_sync(a);
     if (valt_in<VarList>(a) and get<VarList>(a).v.size() == 0)
         throw CoreError("empty cont-list");
-    return make_shared<Var>(VarBool{
+    return make_var(VarBool{
             valt_in<VarCons>(a) and nullptr == get<VarCons>(a).c});
 }
 
@@ -931,13 +1493,16 @@ EnvEntry f_listp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("list? argc");
     auto & a = *args[0];
+    view_sync(a);
+    if (valt_in<VarView>(a))
+        return make_var(VarBool{not get<VarView>(a).s->dot});
     if (valt_in<VarList>(a)) {
         if (get<VarList>(a).v.size() == 0)
             throw CoreError("empty cont-list");
-        return make_shared<Var>(VarBool{true});
+        return make_var(VarBool{true});
     }
     if (not valt_in<VarCons>(a))
-        return make_shared<Var>(VarBool{false});
+        return make_var(VarBool{false});
 
     ConsNext x = get<VarCons>(a).c;
     warn("cons-iter", args);
@@ -946,7 +1511,7 @@ EnvEntry f_listp(span<EnvEntry> args)
         if (nullptr == get<ConsPtr>(x)) break;
         x = get<ConsPtr>(x)->d;
     }
-    return make_shared<Var>(VarBool{
+    return make_var(VarBool{
             holds_alternative<ConsPtr>(x)});
 }
 
@@ -954,14 +1519,14 @@ EnvEntry f_pairp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("pair? argc");
     auto & a = *args[0];
-    if (valt_in<VarNonlist>(a))
-        return make_shared<Var>(VarBool{true});
+    if (valt_in<VarNonlist, VarView>(a))
+        return make_var(VarBool{true});
     if (valt_in<VarList>(a)) {
         if (get<VarList>(a).v.size() == 0)
             throw CoreError("empty cont-list");
-        return make_shared<Var>(VarBool{true});
+        return make_var(VarBool{true});
     }
-    return make_shared<Var>(VarBool{
+    return make_var(VarBool{
         valt_in<VarCons>(a) and nullptr != get<VarCons>(a).c});
 }
 
@@ -969,14 +1534,15 @@ EnvEntry f_contpp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("cont?? argc");
     // warn("uses cont??", args);
-    return make_shared<Var>(
-            VarBool{valt_in<VarList, VarNonlist>(*args[0])});
+    view_sync(*args[0]);
+    return make_var(
+            VarBool{valt_in<VarList, VarNonlist, VarView>(*args[0])});
 }
 
 EnvEntry f_voidp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("void? argc");
-    return make_shared<Var>(VarBool{valt_in<VarVoid>(*args[0])});
+    return make_var(VarBool{valt_in<VarVoid>(*args[0])});
 }
 
 //
@@ -986,49 +1552,335 @@ EnvEntry f_voidp(span<EnvEntry> args)
 EnvEntry f_length(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("length argc");
-    valt_or_fail<VarCons, VarList>(args, 0, "length");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "length");
     auto & a = *args[0];
     long long r{};
-    if (holds_alternative<VarCons>(a)) {
+    view_sync(a);
+    if (holds_alternative<VarView>(a)) {
+        auto & w = get<VarView>(a);
+        if (w.s->dot) throw RunError("length on nonlist");
+        r = w.s->size() - w.i;
+    } else if (holds_alternative<VarCons>(a)) {
         if (get<VarCons>(a).c)
             r = get<VarCons>(a).c->length();
     } else {
         r = get<VarList>(a).v.size();
     }
-    return make_shared<Var>(VarNum{r});
+    return make_var(VarNum{r});
 }
 
 EnvEntry f_apply(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("apply argc");
-    valt_or_fail<VarCons, VarList>(args, 1, "apply");
+    valt_or_fail<VarCons, VarList, VarView>(args, 1, "apply");
     vector<EnvEntry> e{args[0]};
     for (auto & v : normal_list(*args[1]).v)
         e.push_back(v);
     return xapply(e);
 }
 
-EnvEntry f_map(span<EnvEntry> args)
+bool is_true(Var & v)
 {
-    if (args.size() < 1) throw RunError("map argc");
-    valt_or_fail<VarFunOps, VarFunHost>(args, 0, "map");
+    return not valt_in<VarBool>(v) or get<VarBool>(v).b;
+}
+
+// Walks lists in step, placing the current elements in a buffer
+// of arguments for proc, which is re-used for each call.  The
+// lists are args from i and proc is args[0].  The elements go
+// in the buffer from at, and room is left for extra after them.
+struct StepArgs {
+    vector<EnvEntry> w;
     vector<unique_ptr<ConsOrListIter>> inputs;
-    for (size_t i = 1; i != args.size(); ++i) {
-        valt_or_fail<VarCons, VarList>(args, i, "map");
-        inputs.push_back(make_iter(*args[i]));
+    size_t at;
+    StepArgs(span<EnvEntry> args, size_t i, size_t at, const string & s,
+            size_t extra = 0)
+        : w(at + args.size() - i + extra), at(at)
+    {
+        if (args.size() <= i) throw RunError(s + " argc");
+        valt_or_fail<VarFunOps, VarFunHost>(args, 0, s);
+        w[0] = args[0];
+        for (; i != args.size(); ++i) {
+            valt_or_fail<VarCons, VarList, VarView>(args, i, s);
+            inputs.push_back(make_iter(*args[i]));
+        }
     }
-    vector<EnvEntry> r;
-    for (;;) {
-        vector<EnvEntry> w{args[0]};
-        for (auto & j : inputs) {
-            auto x = j->get();
-            if (x) w.push_back(x);
-            else goto e;
+    bool next()
+    {
+        for (size_t k{}; k != inputs.size(); ++k) {
+            auto x = inputs[k]->get();
+            if (not x) return false;
+            w[at + k] = move(x);
         }
-        r.push_back(fun_call(w));
+        return true;
+    }
+    EnvEntry call() { return fun_call(w); }
+};
+
+EnvEntry f_map(span<EnvEntry> args)
+{
+    StepArgs a(args, 1, 1, "map");
+    vector<EnvEntry> r;
+    while (a.next())
+        r.push_back(a.call());
+    return list_or_empty(move(r));
+}
+
+// note: each task copies the procedure once, on its worker, and
+//       the elements as it takes them, so that the workers share
+//       nothing mutable.  what a call gives back is then reached
+//       only from there.  a task stops at its first error, and the
+//       error of the first element that has one is raised.
+vector<EnvEntry> parallel_calls(span<EnvEntry> args, const string & s,
+        bool keep)
+{
+    StepArgs a(args, 1, 1, s);
+    vector<vector<EnvEntry>> calls;
+    while (a.next())
+        calls.push_back(a.w);
+    if (calls.empty()) return {};
+    auto & pool = WorkPool::shared();
+    struct Task {
+        size_t at;
+        exception_ptr e;
+    };
+    vector<Task> tasks(min(calls.size(), pool.size()), {calls.size(), {}});
+    vector<EnvEntry> r(keep ? calls.size() : 0);
+    atomic<size_t> next{0};
+    atomic<size_t> left{tasks.size()};
+    for (auto & x : tasks)
+        pool.submit([&x, &calls, &r, &next, &left, keep] {
+            TransferSeen seen;
+            {
+                Transfer t;
+                vector<EnvEntry> w;
+                for (size_t i; (i = next++) < calls.size(); ) {
+                    try {
+                        w.clear();
+                        for (auto & e : calls[i]) w.push_back(t(e));
+                        auto y = fun_call(w);
+                        if (keep) r[i] = move(y);
+                    } catch (...) {
+                        x = {i, current_exception()};
+                        break;
+                    }
+                }
+                seen = move(t.seen);
+            }
+            // note: the copy is dropped here, and its cycles collected
+            seen.note();
+            gc_collect();
+            --left;
+        });
+    pool.wait(left);
+    calls.clear();
+    auto e = min_element(tasks.begin(), tasks.end(),
+            [](auto & x, auto & y) { return x.at < y.at; });
+    if (e->e) rethrow_exception(e->e);
+    return r;
+}
+
+EnvEntry f_parallel_map(span<EnvEntry> args)
+{
+    return list_or_empty(parallel_calls(args, "parallel-map", true));
+}
+
+// note: as each call is on copies, what it sets of the vars is not
+//       seen here, only what it does outside, as output
+EnvEntry f_parallel_for_each(span<EnvEntry> args)
+{
+    parallel_calls(args, "parallel-for-each", false);
+    return make_var(VarVoid{});
+}
+
+EnvEntry f_for_each(span<EnvEntry> args)
+{
+    StepArgs a(args, 1, 1, "for-each");
+    while (a.next())
+        a.call();
+    return make_var(VarVoid{});
+}
+
+EnvEntry f_filter(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("filter argc");
+    StepArgs a(args, 1, 1, "filter");
+    vector<EnvEntry> r;
+    while (a.next()) {
+        auto x = a.w[1];
+        if (is_true(*a.call()))
+            r.push_back(move(x));
+    }
+    return list_or_empty(move(r));
+}
+
+EnvEntry f_fold_left(span<EnvEntry> args)
+{
+    if (args.size() < 3) throw RunError("fold-left argc");
+    StepArgs a(args, 2, 2, "fold-left");
+    auto r = args[1];
+    while (a.next()) {
+        a.w[1] = r;
+        r = a.call();
+    }
+    return r;
+}
+
+EnvEntry f_fold(span<EnvEntry> args)
+{
+    if (args.size() < 3) throw RunError("fold argc");
+    StepArgs a(args, 2, 1, "fold", 1);
+    auto r = args[1];
+    auto n = a.w.size() - 1;
+    while (a.next()) {
+        a.w[n] = r;
+        r = a.call();
+    }
+    return r;
+}
+
+EnvEntry f_fold_right(span<EnvEntry> args)
+{
+    if (args.size() < 3) throw RunError("fold-right argc");
+    valt_or_fail<VarFunOps, VarFunHost>(args, 0, "fold-right");
+    // note: from the right so, elements of the shortest list first
+    vector<vector<EnvEntry>> v;
+    size_t m = -1;
+    for (size_t i = 2; i != args.size(); ++i) {
+        valt_or_fail<VarCons, VarList, VarView>(args, i, "fold-right");
+        v.push_back(normal_list(*args[i]).v);
+        m = min(m, v.back().size());
+    }
+    vector<EnvEntry> w(v.size() + 2);
+    w[0] = args[0];
+    auto r = args[1];
+    while (m--) {
+        for (size_t k{}; k != v.size(); ++k)
+            w[k + 1] = v[k][m];
+        w.back() = r;
+        r = fun_call(w);
+    }
+    return r;
+}
+
+EnvEntry f_reduce(span<EnvEntry> args)
+{
+    if (args.size() != 3) throw RunError("reduce argc");
+    StepArgs a(args, 2, 1, "reduce", 1);
+    if (not a.next()) return args[1];
+    auto r = a.w[1];
+    while (a.next()) {
+        a.w[2] = r;
+        r = a.call();
+    }
+    return r;
+}
+
+EnvEntry f_count(span<EnvEntry> args)
+{
+    StepArgs a(args, 1, 1, "count");
+    long long n{};
+    while (a.next())
+        if (is_true(*a.call())) ++n;
+    return make_var(VarNum{n});
+}
+
+EnvEntry f_find(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("find argc");
+    StepArgs a(args, 1, 1, "find");
+    while (a.next()) {
+        auto x = a.w[1];
+        if (is_true(*a.call())) return x;
+    }
+    return make_var(VarBool{false});
+}
+
+EnvEntry f_any(span<EnvEntry> args)
+{
+    StepArgs a(args, 1, 1, "any");
+    while (a.next())
+        if (auto r = a.call(); is_true(*r)) return r;
+    return make_var(VarBool{false});
+}
+
+EnvEntry f_every(span<EnvEntry> args)
+{
+    StepArgs a(args, 1, 1, "every");
+    EnvEntry r = make_var(VarBool{true});
+    while (a.next())
+        if (r = a.call(); not is_true(*r)) return r;
+    return r;
+}
+
+// note: the comparator is called through a reused argument
+//       buffer, and when it is one of the builtin orderings on
+//       numbers or strings the elements are compared directly.
+struct SortLess {
+    vector<EnvEntry> w;
+    SortLess(EnvEntry f) : w{f, {}, {}} { }
+    bool operator()(const EnvEntry & a, const EnvEntry & b)
+    {
+        w[1] = a;
+        w[2] = b;
+        return is_true(*fun_call(w));
+    }
+};
+
+template <typename T>
+bool all_of_type(vector<EnvEntry> & v)
+{
+    for (auto & x : v)
+        if (not holds_alternative<T>(*x)) return false;
+    return true;
+}
+
+bool num_lt(const EnvEntry & a, const EnvEntry & b)
+{ return get<VarNum>(*a).i < get<VarNum>(*b).i; }
+bool num_gt(const EnvEntry & a, const EnvEntry & b)
+{ return get<VarNum>(*a).i > get<VarNum>(*b).i; }
+bool str_lt(const EnvEntry & a, const EnvEntry & b)
+{ return get<VarString>(*a).s < get<VarString>(*b).s; }
+bool str_gt(const EnvEntry & a, const EnvEntry & b)
+{ return get<VarString>(*a).s > get<VarString>(*b).s; }
+
+EnvEntry sort_list(EnvEntry & x, EnvEntry f, const string & s)
+{
+    auto v = normal_list(*x).v;
+    if (v.empty()) return make_var(VarCons{});
+    FunHost p{};
+    if (not f) p = f_lt;
+    else if (holds_alternative<VarFunHost>(*f)) p = get<VarFunHost>(*f).p;
+    if ((p == f_lt or p == f_gt) and all_of_type<VarNum>(v)) {
+        stable_sort(v.begin(), v.end(), p == f_lt ? num_lt : num_gt);
+    } else if ((p == f_stringltp or p == f_stringgtp or not f)
+            and all_of_type<VarString>(v)) {
+        stable_sort(v.begin(), v.end(), p == f_stringgtp ? str_gt : str_lt);
+    } else if (not f) {
+        throw RunError(s + " without less? on other than number or string");
+    } else {
+        stable_sort(v.begin(), v.end(), SortLess(f));
+    }
+    return make_var(VarList{move(v)});
+}
+
+EnvEntry f_sort(span<EnvEntry> args)
+{
+    if (args.size() != 1 and args.size() != 2) throw RunError("sort argc");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "sort");
+    EnvEntry f;
+    if (args.size() == 2) {
+        valt_or_fail<VarFunOps, VarFunHost>(args, 1, "sort");
+        f = args[1];
     }
-e:
-    return make_shared<Var>(VarList{move(r)});
+    return sort_list(args[0], f, "sort");
+}
+
+EnvEntry f_list_sort(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("list-sort argc");
+    valt_or_fail<VarFunOps, VarFunHost>(args, 0, "list-sort");
+    valt_or_fail<VarCons, VarList, VarView>(args, 1, "list-sort");
+    return sort_list(args[1], args[0], "list-sort");
 }
 
 struct SearchPred {
@@ -1041,10 +1893,7 @@ struct SearchPred {
 struct SearchEqual : SearchPred {
     using SearchPred::SearchPred;
     bool operator()(EnvEntry x) override final {
-        vector<EnvEntry> w{a, x};
-        auto v = f_equalp(w);
-        return not valt_in<VarBool>(*v)
-            or get<VarBool>(*v).b;
+        return is_equal(*a, *x);
     }
 };
 
@@ -1061,28 +1910,38 @@ struct SearchWithFun : SearchPred {
 EnvEntry f_member(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("member argc");
-    valt_or_fail<VarCons, VarList, VarNonlist>(args, 1, "member");
-    EnvEntry f = make_shared<Var>(VarBool{false});
+    valt_or_fail<VarCons, VarList, VarNonlist, VarView>(args, 1, "member");
+    EnvEntry f = make_var(VarBool{false});
     unique_ptr<SearchPred> t;
     if (valt_in<VarFunOps, VarFunHost>(*args[0]))
         t = make_unique<SearchWithFun>(args[0]);
     else t = make_unique<SearchEqual>(args[0]);
-    if (valt_in<VarCons>(*args[1])) {
-        auto & c = get<VarCons>(*args[1]).c;
+    auto & x = *args[1];
+    to_view(x);
+    view_sync(x);
+    ConsNext r;
+    if (valt_in<VarView>(x)) {
+        auto w = get<VarView>(x);
+        auto & s = *w.s;
+        auto i = w.i;
+        // note: pred may have the cells made, then go on with them
+        while (s.cells.empty()) {
+            if (w.i == s.size()) {
+                if (not s.dot) return f;
+                warn("member hit non-cons cdr", args);
+                if ((*t)(s.v.back())) return s.v.back();
+                return f;
+            }
+            if ((*t)(s.v[w.i])) return make_var(w);
+            ++w.i;
+        }
+        r = (w.i == i) ? ConsNext{s.cells[i]} : s.cells[w.i - 1]->d;
+    } else {
+        auto & c = get<VarCons>(x).c;
         if (not c) return f;
         if ((*t)(c->a)) return args[1];
-    } else {
-        vector<EnvEntry> * v{};
-        if (valt_in<VarList>(*args[1])) v = &get<VarList>(*args[1]).v;
-        else v = &get<VarNonlist>(*args[1]).v;
-        if ((*v).size() == 0) return f;
-        if ((*t)((*v)[0])) {
-            vector<EnvEntry> a{args[1]};
-            return f_dup(a);
-        }
+        r = c->d;
     }
-    auto q = f_cdr({args.begin() + 1, args.end()});
-    ConsNext r = get<VarCons>(*q).c;
     for (;;) {
         if (not holds_alternative<ConsPtr>(r)) {
             warn("member hit non-cons cdr", args);
@@ -1094,7 +1953,7 @@ EnvEntry f_member(span<EnvEntry> args)
         auto & c = get<ConsPtr>(r);
         if (not c) break;
         if ((*t)(c->a))
-            return make_shared<Var>(VarCons{c});
+            return make_var(VarCons{c});
         r = c->d;
     }
     return f;
@@ -1103,13 +1962,20 @@ EnvEntry f_member(span<EnvEntry> args)
 EnvEntry f_assoc(span<EnvEntry> args)
 {
     if (args.size() != 2) throw RunError("assoc argc");
-    valt_or_fail<VarCons, VarList, VarNonlist>(args, 1, "assoc");
-    EnvEntry f = make_shared<Var>(VarBool{false});
+    valt_or_fail<VarCons, VarList, VarNonlist, VarView>(args, 1, "assoc");
+    EnvEntry f = make_var(VarBool{false});
     unique_ptr<SearchPred> t;
     if (valt_in<VarFunOps, VarFunHost>(*args[0]))
         t = make_unique<SearchWithFun>(args[0]);
     else t = make_unique<SearchEqual>(args[0]);
-    if (valt_in<VarCons>(*args[1])) {
+    view_sync(*args[1]);
+    if (valt_in<VarView>(*args[1])) {
+        auto j = make_iter(*args[1]);
+        while (auto x = j->get()) {
+            vector<EnvEntry> w{x};
+            if ((*t)(f_car(w))) return x;
+        }
+    } else if (valt_in<VarCons>(*args[1])) {
         ConsNext r = get<VarCons>(*args[1]).c;
         for (;;) {
             if (not holds_alternative<ConsPtr>(r)) {
@@ -1120,7 +1986,7 @@ EnvEntry f_assoc(span<EnvEntry> args)
             if (not p) break;
             vector<EnvEntry> w{p->a};
             if ((*t)(f_car(w)))
-                return make_shared<Var>(VarCons{p});
+                return p->a;
             r = p->d;
         }
     } else {
@@ -1135,6 +2001,234 @@ EnvEntry f_assoc(span<EnvEntry> args)
     return f;
 }
 
+//
+// hash table
+//
+
+int t_hash_table;
+
+void delete_hash_table(void * u)
+{
+    delete static_cast<HashTable *>(u);
+}
+
+void hash_table_walk(void * u, const function<void(EnvEntry &)> & f)
+{
+    static_cast<HashTable *>(u)->walk(f);
+}
+
+void * hash_table_transfer(void * u, Transfer & t)
+{
+    return static_cast<HashTable *>(u)->copy(
+            [&t](EnvEntry & e) { return t(e); });
+}
+
+HashTable & table_or_fail(span<EnvEntry> args, const string & s)
+{
+    auto & e = vext_or_fail({t_hash_table}, args, 0, s);
+    return *static_cast<HashTable *>(e.u);
+}
+
+EnvEntry f_make_hash_table(span<EnvEntry> args)
+{
+    if (args.size() > 1) throw RunError("make-hash-table argc");
+    HashTable::Hash h = hash_equal;
+    HashTable::Equal q = is_equal;
+    if (args.size() == 1) {
+        valt_or_fail<VarFunHost>(args, 0, "make-hash-table");
+        auto p = get<VarFunHost>(*args[0]).p;
+        if (p == f_eqp or p == f_stringeqp) {
+            h = hash_eqv;
+            q = is_eqv;
+        } else if (p != f_equalp) {
+            throw RunError("make-hash-table expects eq?, eqv?,"
+                    " equal? or string=?");
+        }
+    }
+    auto r = VarExt{t_hash_table};
+    r.u = new HashTable(h, q);
+    r.f = delete_hash_table;
+    return make_var(move(r));
+}
+
+EnvEntry f_hash_tablep(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("hash-table? argc");
+    return make_var(VarBool{
+            holds_alternative<VarExt>(*args[0])
+            and get<VarExt>(*args[0]).t == t_hash_table});
+}
+
+EnvEntry f_hash_table_setj(span<EnvEntry> args)
+{
+    if (args.size() != 3) throw RunError("hash-table-set! argc");
+    auto & t = table_or_fail(args, "hash-table-set!");
+    keeps(args[1]);
+    keeps(args[2]);
+    t.set(args[1], args[2]);
+    gc_candidate(args[0]);
+    return make_var(VarVoid{});
+}
+
+EnvEntry f_hash_table_ref(span<EnvEntry> args)
+{
+    if (args.size() != 2 and args.size() != 3)
+        throw RunError("hash-table-ref argc");
+    auto & t = table_or_fail(args, "hash-table-ref");
+    if (auto v = t.get(args[1]); v) return v;
+    if (args.size() == 2) throw RunError("hash-table-ref key not found");
+    valt_or_fail<VarFunOps, VarFunHost>(args, 2, "hash-table-ref");
+    vector<EnvEntry> w{args[2]};
+    return fun_call(w);
+}
+
+EnvEntry f_hash_table_ref_default(span<EnvEntry> args)
+{
+    if (args.size() != 3) throw RunError("hash-table-ref/default argc");
+    auto & t = table_or_fail(args, "hash-table-ref/default");
+    if (auto v = t.get(args[1]); v) return v;
+    return args[2];
+}
+
+EnvEntry f_hash_table_deletej(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("hash-table-delete! argc");
+    auto & t = table_or_fail(args, "hash-table-delete!");
+    t.erase(args[1]);
+    return make_var(VarVoid{});
+}
+
+EnvEntry f_hash_table_containsp(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("hash-table-contains? argc");
+    auto & t = table_or_fail(args, "hash-table-contains?");
+    return make_var(VarBool{t.get(args[1]) != nullptr});
+}
+
+EnvEntry f_hash_table_count(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("hash-table-count argc");
+    auto & t = table_or_fail(args, "hash-table-count");
+    return make_var(VarNum{static_cast<long long>(t.size())});
+}
+
+EnvEntry f_hash_table_walk(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("hash-table-walk argc");
+    auto & t = table_or_fail(args, "hash-table-walk");
+    valt_or_fail<VarFunOps, VarFunHost>(args, 1, "hash-table-walk");
+    // note: on a snapshot, so that proc may alter the table
+    for (auto & p : t.items()) {
+        vector<EnvEntry> w{args[1], p.first, p.second};
+        fun_call(w);
+    }
+    return make_var(VarVoid{});
+}
+
+EnvEntry f_hash_table_z_alist(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("hash-table->alist argc");
+    auto & t = table_or_fail(args, "hash-table->alist");
+    vector<EnvEntry> r;
+    for (auto & p : t.items()) {
+        vector<EnvEntry> v{p.first, p.second};
+        r.push_back(make_var(VarNonlist{move(v)}));
+    }
+    if (r.empty()) return make_var(VarCons{});
+    return make_var(VarList{move(r)});
+}
+
+//
+// future
+//
+
+int t_future;
+
+// note: the result is made on the worker, and is reached from
+//       here only once the task has let go of all else
+struct Future {
+    atomic<size_t> left{1};
+    EnvEntry r;
+    exception_ptr e;
+};
+
+using FuturePtr = shared_ptr<Future>;
+
+void delete_future(void * u)
+{
+    delete static_cast<FuturePtr *>(u);
+}
+
+void future_walk(void * u, const function<void(EnvEntry &)> & f)
+{
+    auto & p = *static_cast<FuturePtr *>(u);
+    if (not p->left and p->r) f(p->r);
+}
+
+EnvEntry f_spawn(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("spawn argc");
+    valt_or_fail<VarFunOps, VarFunHost>(args, 0, "spawn");
+    auto p = make_shared<Future>();
+    EnvEntry f;
+    TransferSeen seen;
+    {
+        Transfer t;
+        f = t(args[0]);
+        seen = move(t.seen);
+    }
+    WorkPool::shared().submit([p, f = move(f), seen = move(seen)] () mutable {
+        try {
+            vector<EnvEntry> w{move(f)};
+            p->r = fun_call(w);
+        } catch (...) {
+            p->e = current_exception();
+        }
+        f = nullptr;
+        seen.note();
+        gc_collect();
+        --p->left;
+    });
+    auto r = VarExt{t_future};
+    r.u = new FuturePtr(move(p));
+    r.f = delete_future;
+    return make_var(move(r));
+}
+
+EnvEntry f_futurep(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("future? argc");
+    return make_var(VarBool{
+            holds_alternative<VarExt>(*args[0])
+            and get<VarExt>(*args[0]).t == t_future});
+}
+
+EnvEntry await(span<EnvEntry> args, size_t i, const string & s)
+{
+    auto & e = vext_or_fail({t_future}, args, i, s);
+    auto & p = *static_cast<FuturePtr *>(e.u);
+    WorkPool::shared().wait(p->left);
+    if (p->e) rethrow_exception(p->e);
+    return p->r;
+}
+
+EnvEntry f_await(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("await argc");
+    return await(args, 0, "await");
+}
+
+EnvEntry f_await_all(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("await-all argc");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "await-all");
+    auto v = normal_list(*args[0]).v;
+    vector<EnvEntry> r;
+    for (size_t i = 0; i != v.size(); ++i)
+        r.push_back(await(v, i, "await-all"));
+    return list_or_empty(move(r));
+}
+
 // display functions (see also, I/O functions)
 //
 //   for development purposes and as of r7rs, not suggested for
@@ -1142,14 +2236,15 @@ EnvEntry f_assoc(span<EnvEntry> args)
 
 EnvEntry f_display(span<EnvEntry> args)
 {
+    Printer p(*u_names, cout);
     for (auto & a : args) {
-        if (&a != &args[0]) cout << ' ';
+        if (&a != &args[0]) p.put(" ");
         if (holds_alternative<VarString>(*a))
-            cout << get<VarString>(*a).s;
+            p.put(get<VarString>(*a).s);
         else
-            print(a, *u_names, cout);
+            p.print(a);
     }
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 //
@@ -1163,7 +2258,7 @@ EnvEntry f_read(span<EnvEntry> args)
     auto & s = get<VarString>(*args[0]).s;
     auto t = readx(s, *u_names);
     if (t.v.size() == 0)
-        return make_shared<Var>(VarVoid{});
+        return make_var(VarVoid{});
     if (t.v.size() != 1)
         warn("trailing objects", args);
     return from_lex(t.v[0]);
@@ -1172,9 +2267,9 @@ EnvEntry f_read(span<EnvEntry> args)
 EnvEntry f_write(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("write argc");
-    ostringstream f;
-    print(args[0], *u_names, f);
-    return make_shared<Var>(VarString{f.str()});
+    string r;
+    Printer(*u_names, r).print(args[0]);
+    return make_var(VarString{move(r)});
 }
 
 //
@@ -1219,6 +2314,15 @@ void init_functions(Names & n)
     auto & g = GlobalEnv::initial();
     typedef EnvEntry (*hp)(span<EnvEntry> args);
     if (n.size() != NAM__KNOWN) throw CoreError("init names expected");
+    ext_type(t_hash_table, n, "hash-table");
+    ext_type(t_string_pattern, n, "string-pattern");
+    ext_type(t_regex, n, "regex");
+    ext_type(t_future, n, "future");
+    gc_ext_walk(t_hash_table, hash_table_walk);
+    gc_ext_walk(t_future, future_walk);
+    transfer_ext(t_hash_table, hash_table_transfer);
+    transfer_ext(t_string_pattern, nullptr);
+    transfer_ext(t_regex, regex_transfer);
     for (auto & p : initializer_list<pair<string, hp>>{
             { "list", f_list },
             { "nonlist", f_nonlist },
@@ -1257,6 +2361,10 @@ void init_functions(Names & n)
             { ">=", f_gte },
             { "set!", f_setj },
             { "set!!", f_setjj },
+            { "gc", f_gc },
+            { "gc-threshold", f_gc_threshold },
+            { "heap-stats", f_heap_stats },
+            { "trace-dump", f_trace_dump },
             { "dup", f_dup },
             { "alias?", f_aliasp },
             { "eq?", f_eqp },
@@ -1272,11 +2380,30 @@ void init_functions(Names & n)
             { "symbol->string", f_symbol_z_string },
             { "substring", f_substring },
             { "substring-index", f_substring_index },
+            { "make-string-pattern", f_make_string_pattern },
+            { "string-pattern?", f_string_patternp },
+            { "string-search-all", f_string_search_all },
+            { "regex-compile", f_regex_compile },
+            { "regex?", f_regexp },
+            { "regex-match", f_regex_match },
+            { "regex-search", f_regex_search },
+            { "regex-split", f_regex_split },
+            { "regex-replace", f_regex_replace },
             { "string-length", f_string_length },
             { "string-append", f_string_append },
             { "string=?", f_stringeqp },
             { "string<?", f_stringltp },
             { "string>?", f_stringgtp },
+            { "string-prefix?", f_string_prefixp },
+            { "string-suffix?", f_string_suffixp },
+            { "string-split", f_string_split },
+            { "string-join", f_string_join },
+            { "string-trim", f_string_trim },
+            { "string-trim-left", f_string_trim_left },
+            { "string-trim-right", f_string_trim_right },
+            { "string-index", f_string_index },
+            { "string-upcase", f_string_upcase },
+            { "string-downcase", f_string_downcase },
             { "string->number", f_string_z_number },
             { "number->string", f_number_z_string },
             { "boolean?", f_booleanp },
@@ -1294,11 +2421,41 @@ void init_functions(Names & n)
             { "length", f_length },
             { "apply", f_apply },
             { "map", f_map },
+            { "parallel-map", f_parallel_map },
+            { "parallel-for-each", f_parallel_for_each },
+            { "for-each", f_for_each },
+            { "filter", f_filter },
+            { "fold", f_fold },
+            { "fold-left", f_fold_left },
+            { "fold-right", f_fold_right },
+            { "reduce", f_reduce },
+            { "count", f_count },
+            { "find", f_find },
+            { "any", f_any },
+            { "every", f_every },
+            { "sort", f_sort },
+            { "list-sort", f_list_sort },
             { "member", f_member },
             { "assoc", f_assoc },
+            { "make-hash-table", f_make_hash_table },
+            { "hash-table?", f_hash_tablep },
+            { "hash-table-set!", f_hash_table_setj },
+            { "hash-table-ref", f_hash_table_ref },
+            { "hash-table-ref/default", f_hash_table_ref_default },
+            { "hash-table-delete!", f_hash_table_deletej },
+            { "hash-table-contains?", f_hash_table_containsp },
+            { "hash-table-count", f_hash_table_count },
+            { "hash-table-walk", f_hash_table_walk },
+            { "hash-table->alist", f_hash_table_z_alist },
+            { "spawn", f_spawn },
+            { "future?", f_futurep },
+            { "await", f_await },
+            { "await-all", f_await_all },
             { "error", f_error },
             { "exit", f_exit },
-    }) g.set(n.intern(p.first), make_shared<Var>(VarFunHost{ p.second }));
+    }) g.set(n.intern(p.first), make_var(VarFunHost{ p.second }));
+    trace_io(f_display);
+    trace_io(f_write);
 }
 
 } // ns
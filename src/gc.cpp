@@ -0,0 +1,217 @@
+#include "gc.hpp"
+#include "cons.hpp"
+#include "eval.hpp"
+#include <unordered_map>
+#include <map>
+#include <algorithm>
+
+using namespace std;
+using namespace humble;
+
+namespace {
+
+constexpr size_t GC_THRESHOLD = 10000;
+
+struct GcCandidate {
+    int kind;
+    weak_ptr<void> p;
+};
+
+thread_local vector<GcCandidate> candidates;
+thread_local size_t threshold = GC_THRESHOLD;
+map<int, GcWalk> ext_walks;  // note: only added to at init
+
+struct GcNode {
+    int kind;
+    void * p;
+    long rc;        // references, all of them
+    long internal;  // references from within the graph
+    bool live;
+};
+
+enum { K_VAR, K_CONS, K_FUN, K_STORE };
+
+template <typename T> int kind_of();
+template <> int kind_of<Var>() { return K_VAR; }
+template <> int kind_of<Cons>() { return K_CONS; }
+template <> int kind_of<FunOps>() { return K_FUN; }
+template <> int kind_of<ListStore>() { return K_STORE; }
+
+// note: f is given each shared_ptr held by the object, by reference
+//       so that the unlinking may move it away.
+template <typename F>
+void edges(GcNode & n, F && f)
+{
+    auto each = [&f](vector<EnvEntry> & v) { for (auto & e : v) f(e); };
+    switch (n.kind) {
+    case K_VAR:
+        visit([&](auto && w) {
+            using T = decay_t<decltype(w)>;
+            if constexpr (is_same_v<T, VarList> or is_same_v<T, VarNonlist>
+                    or is_same_v<T, VarRec> or is_same_v<T, VarSplice>) {
+                each(w.v);
+            } else if constexpr (is_same_v<T, VarApply>) {
+                each(w.a);
+            } else if constexpr (is_same_v<T, VarCons>) {
+                f(w.c);
+            } else if constexpr (is_same_v<T, VarView>) {
+                f(w.s);
+            } else if constexpr (is_same_v<T, VarFunOps>) {
+                f(w.f);
+            } else if constexpr (is_same_v<T, VarExt>) {
+                auto it = ext_walks.find(w.t);
+                if (it != ext_walks.end() and w.u)
+                    it->second(w.u, [&f](EnvEntry & e) { f(e); });
+            }
+        }, *static_cast<Var *>(n.p));
+        break;
+    case K_CONS: {
+        auto & c = *static_cast<Cons *>(n.p);
+        f(c.a);
+        if (holds_alternative<ConsPtr>(c.d)) f(get<ConsPtr>(c.d));
+        else f(get<EnvEntry>(c.d));
+        break;
+    }
+    case K_FUN:
+        for (auto & e : fun_captured(*static_cast<FunOps *>(n.p)).entries())
+            f(e);
+        break;
+    case K_STORE: {
+        auto & s = *static_cast<ListStore *>(n.p);
+        each(s.v);
+        for (auto & c : s.cells) f(c);
+        break;
+    }
+    }
+}
+
+struct Collect {
+    vector<GcNode> nodes;
+    unordered_map<void *, size_t> index;
+    vector<size_t> todo;
+
+    template <typename T>
+    size_t node(shared_ptr<T> & x)
+    {
+        auto [it, fresh] = index.emplace(x.get(), nodes.size());
+        if (fresh) {
+            nodes.push_back({kind_of<T>(), x.get(), x.use_count(), 0, false});
+            todo.push_back(it->second);
+        }
+        return it->second;
+    }
+
+    size_t root(shared_ptr<void> & p, int kind)
+    {
+        size_t i;
+        if (kind == K_CONS) {
+            auto c = static_pointer_cast<Cons>(p);
+            i = node(c);
+        } else if (kind == K_STORE) {
+            auto s = static_pointer_cast<ListStore>(p);
+            i = node(s);
+        } else {
+            auto e = static_pointer_cast<Var>(p);
+            i = node(e);
+        }
+        --nodes[i].rc;  // note: the one of the cast
+        return i;
+    }
+
+    size_t i_of_back()
+    {
+        size_t i = todo.back();
+        todo.pop_back();
+        return i;
+    }
+
+    // note: the node is copied as the walk grows the nodes
+    void discover()
+    {
+        while (not todo.empty()) {
+            GcNode n = nodes[i_of_back()];
+            edges(n, [this](auto & x) {
+                if (x) ++nodes[node(x)].internal;
+            });
+        }
+    }
+
+    void mark(size_t i)
+    {
+        todo.push_back(i);
+        while (not todo.empty()) {
+            size_t j = i_of_back();
+            if (nodes[j].live) continue;
+            nodes[j].live = true;
+            edges(nodes[j], [this](auto & x) {
+                if (x) todo.push_back(index.at(x.get()));
+            });
+        }
+    }
+};
+
+void add_candidate(int kind, weak_ptr<void> p)
+{
+    candidates.push_back({kind, move(p)});
+    if (threshold and candidates.size() >= threshold)
+        gc_collect();
+}
+
+} // ans
+
+namespace humble {
+
+void gc_candidate(const EnvEntry & e) { add_candidate(K_VAR, e); }
+
+void gc_candidate(const shared_ptr<Cons> & c) { add_candidate(K_CONS, c); }
+
+void gc_candidate(const shared_ptr<ListStore> & s)
+{
+    add_candidate(K_STORE, s);
+}
+
+size_t gc_collect()
+{
+    vector<pair<shared_ptr<void>, int>> roots;
+    for (auto & c : candidates)
+        if (auto p = c.p.lock())
+            roots.emplace_back(move(p), c.kind);
+    candidates.clear();
+    sort(roots.begin(), roots.end());
+    roots.erase(unique(roots.begin(), roots.end()), roots.end());
+    Collect g;
+    for (auto & [p, kind] : roots)
+        --g.nodes[g.root(p, kind)].rc;  // note: the one of roots
+    g.discover();
+    for (size_t i = 0; i != g.nodes.size(); ++i)
+        if (g.nodes[i].rc > g.nodes[i].internal)
+            g.mark(i);
+    // note: the links of the garbage are moved away before any is
+    //       released, so that no destructor runs into another.
+    vector<shared_ptr<void>> grave;
+    size_t r{};
+    for (auto & n : g.nodes) {
+        if (n.live) continue;
+        ++r;
+        edges(n, [&grave](auto & x) {
+            if (x) grave.push_back(move(x));
+        });
+    }
+    roots.clear();
+    grave.clear();
+    return r;
+}
+
+size_t gc_threshold(size_t n)
+{
+    swap(threshold, n);
+    return n;
+}
+
+void gc_ext_walk(int t, GcWalk w)
+{
+    ext_walks.emplace(t, w);  // note: same for each interpreter, so
+                              //       one made later does not write
+}
+
+} // ns
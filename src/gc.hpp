@@ -0,0 +1,33 @@
+#ifndef HUMBLE_GC
+#define HUMBLE_GC
+
+#include "vars.hpp"
+#include <functional>
+
+namespace humble {
+
+// Collects what reference counting leaves behind in a cycle, as a
+// closure that captures itself (letrec, named let) or a list made
+// circular by set-cdr!.  What is mutated (the var, or the cons
+// cell or list store in it) is noted as a candidate, and a
+// collection is by trial deletion from those: the graph of vars,
+// cons cells, closures and list stores that they reach is walked,
+// and whatever is only referenced from within it (and not from any
+// live part of it) is unlinked.
+// A collection is not incremental.  It is a full pass over all that
+// the candidates of the thread reach, done when gc_threshold of them
+// are noted or when gc_collect is called, so a candidate that reaches
+// a large part of the heap makes the pass walk that part.
+void gc_candidate(const EnvEntry & e);
+void gc_candidate(const std::shared_ptr<Cons> & c);
+void gc_candidate(const std::shared_ptr<ListStore> & s);
+size_t gc_collect();  // of objects freed
+size_t gc_threshold(size_t n);  // of candidates, 0 for never, gives prior
+
+// Edges of an ext type, for one that holds vars.
+typedef void (* GcWalk)(void * u, const std::function<void(EnvEntry &)> & f);
+void gc_ext_walk(int t, GcWalk w);
+
+} // ns
+
+#endif
@@ -0,0 +1,253 @@
+#include "hashtab.hpp"
+#include "cons.hpp"
+#include "except.hpp"
+#include <string_view>
+#include <functional>
+
+using namespace std;
+using namespace humble;
+
+namespace {
+
+constexpr size_t MIN_SLOTS = 8;
+constexpr size_t HASH_ELEMENTS = 32;  // of a list, the leading ones
+constexpr int HASH_DEPTH = 4;         // nested lists further are opaque
+constexpr size_t SEED_LIST = 0x6c697374;
+constexpr size_t SEED_TAIL = 0x7461696c;
+constexpr size_t SEED_REC = 0x726563;
+
+size_t mix(size_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+size_t combine(size_t h, size_t k)
+{
+    return mix(h ^ (k + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2)));
+}
+
+size_t hash_equal_r(Var & k, int depth);
+
+// note: equal? is such that a list compares by elements whatever
+//       storage (contiguous or cons) that it has, so the hash is
+//       taken from walking the elements and a possible dot tail.
+//       records compare by elements too.
+size_t hash_elements(Var & k, int depth)
+{
+    size_t h = holds_alternative<VarRec>(k) ? SEED_REC : SEED_LIST;
+    if (depth == 0) return h;
+    size_t n{};
+    auto add = [&h, &n, depth](Var & x) {
+        h = combine(h, hash_equal_r(x, depth - 1));
+        return ++n != HASH_ELEMENTS;
+    };
+    if (holds_alternative<VarList>(k) or holds_alternative<VarRec>(k)) {
+        auto & v = holds_alternative<VarList>(k)
+            ? get<VarList>(k).v : get<VarRec>(k).v;
+        for (auto & x : v)
+            if (not add(*x)) break;
+    } else if (holds_alternative<VarNonlist>(k)) {
+        auto & v = get<VarNonlist>(k).v;
+        for (size_t i = 0; i + 1 < v.size(); ++i)
+            if (not add(*v[i])) return h;
+        h = combine(h, SEED_TAIL);
+        add(*v.back());
+    } else if (view_sync(k); holds_alternative<VarView>(k)) {
+        auto & w = get<VarView>(k);
+        auto & s = *w.s;
+        for (size_t i = w.i; i != s.size(); ++i)
+            if (not add(*s.v[i])) return h;
+        if (s.dot) {
+            h = combine(h, SEED_TAIL);
+            add(*s.v.back());
+        }
+    } else {
+        ConsNext c = get<VarCons>(k).c;
+        while (holds_alternative<ConsPtr>(c) and get<ConsPtr>(c)) {
+            auto & p = get<ConsPtr>(c);
+            if (not add(*p->a)) return h;
+            c = p->d;
+        }
+        if (holds_alternative<EnvEntry>(c)) {
+            h = combine(h, SEED_TAIL);
+            add(*get<EnvEntry>(c));
+        }
+    }
+    return h;
+}
+
+size_t hash_equal_r(Var & k, int depth)
+{
+    if (holds_alternative<VarList>(k) or holds_alternative<VarNonlist>(k)
+            or holds_alternative<VarCons>(k) or holds_alternative<VarRec>(k)
+            or holds_alternative<VarView>(k))
+        return hash_elements(k, depth);
+    return hash_eqv(k);
+}
+
+} // ans
+
+namespace humble {
+
+// note: cdr turns a contiguous list into a view, and a view turns
+//       into cons once its cells are made, each with another eqv
+//       hash.  a cons keeps its cell whatever is done to it.
+bool eqv_key(Var & k)
+{
+    if (not holds_alternative<VarList>(k)
+            and not holds_alternative<VarNonlist>(k)
+            and not holds_alternative<VarView>(k))
+        return false;
+    to_view(k);
+    unview(k);
+    return true;
+}
+
+size_t hash_eqv(Var & k)
+{
+    // note: as is_eqv, a cons by its cell, a view by its cell if
+    //       made, else by store and index, and a contiguous list by
+    //       the var.  a list key is set as cons, see eqv_key.
+    if (holds_alternative<VarCons>(k) and get<VarCons>(k).c)
+        return combine(SEED_LIST,
+                reinterpret_cast<size_t>(get<VarCons>(k).c.get()));
+    if (holds_alternative<VarView>(k)) {
+        auto & w = get<VarView>(k);
+        if (not w.s->cells.empty())
+            return combine(SEED_LIST,
+                    reinterpret_cast<size_t>(w.s->cells[w.i].get()));
+        return combine(combine(SEED_TAIL,
+                    reinterpret_cast<size_t>(w.s.get())), w.i);
+    }
+    size_t h = k.index();
+    if (holds_alternative<VarNum>(k))
+        return combine(h, get<VarNum>(k).i);
+    if (holds_alternative<VarString>(k))
+        return combine(h, std::hash<string_view>{}(get<VarString>(k).s));
+    if (holds_alternative<VarBool>(k))
+        return combine(h, get<VarBool>(k).b);
+    if (holds_alternative<VarNam>(k))
+        return combine(h, get<VarNam>(k).h);
+    if (holds_alternative<VarVoid>(k) or holds_alternative<VarCons>(k))
+        return mix(h);
+    return combine(h, reinterpret_cast<size_t>(&k));
+}
+
+size_t hash_equal(Var & k)
+{
+    return hash_equal_r(k, HASH_DEPTH);
+}
+
+HashTable::HashTable(Hash hash, Equal equal)
+    : hash(hash)
+    , equal(equal)
+    , slots(MIN_SLOTS)
+    , n_used()
+    , n_gone()
+{ }
+
+HashTable::Slot * HashTable::find(EnvEntry & k, size_t h)
+{
+    size_t m = slots.size() - 1;
+    for (size_t i = h & m;; i = (i + 1) & m) {
+        auto & s = slots[i];
+        if (s.state == SLOT_FREE)
+            return nullptr;
+        if (s.state == SLOT_USED and s.h == h
+                and (s.k == k or equal(*s.k, *k)))
+            return &s;
+    }
+}
+
+void HashTable::grow()
+{
+    auto w = move(slots);
+    size_t n = MIN_SLOTS;
+    while (n < n_used * 4) n *= 2;
+    slots = vector<Slot>(n);
+    n_gone = 0;
+    size_t m = n - 1;
+    for (auto & s : w) {
+        if (s.state != SLOT_USED) continue;
+        size_t i = s.h & m;
+        while (slots[i].state != SLOT_FREE)
+            i = (i + 1) & m;
+        slots[i] = move(s);
+    }
+}
+
+EnvEntry HashTable::get(EnvEntry & k)
+{
+    if (auto s = find(k, hash(*k)); s)
+        return s->v;
+    return {};
+}
+
+void HashTable::set(EnvEntry k, EnvEntry v)
+{
+    auto h = hash(*k);
+    if (auto s = find(k, h); s) {
+        s->v = v;
+        return;
+    }
+    if (hash == hash_eqv and eqv_key(*k))
+        h = hash(*k);
+    if ((n_used + n_gone + 1) * 4 > slots.size() * 3)
+        grow();
+    size_t m = slots.size() - 1;
+    size_t i = h & m;
+    while (slots[i].state == SLOT_USED)
+        i = (i + 1) & m;
+    auto & s = slots[i];
+    if (s.state == SLOT_GONE) --n_gone;
+    s = Slot{k, v, h, SLOT_USED};
+    ++n_used;
+}
+
+bool HashTable::erase(EnvEntry & k)
+{
+    auto s = find(k, hash(*k));
+    if (not s) return false;
+    *s = Slot{{}, {}, 0, SLOT_GONE};
+    --n_used;
+    ++n_gone;
+    return true;
+}
+
+size_t HashTable::size() const { return n_used; }
+
+vector<pair<EnvEntry, EnvEntry>> HashTable::items()
+{
+    vector<pair<EnvEntry, EnvEntry>> r;
+    r.reserve(n_used);
+    for (auto & s : slots)
+        if (s.state == SLOT_USED)
+            r.emplace_back(s.k, s.v);
+    return r;
+}
+
+// note: set anew, as an eq? hash may be of the address
+HashTable * HashTable::copy(const function<EnvEntry(EnvEntry &)> & f)
+{
+    auto r = new HashTable(hash, equal);
+    for (auto & s : slots)
+        if (s.state == SLOT_USED)
+            r->set(f(s.k), f(s.v));
+    return r;
+}
+
+void HashTable::walk(const function<void(EnvEntry &)> & f)
+{
+    for (auto & s : slots)
+        if (s.state == SLOT_USED) {
+            f(s.k);
+            f(s.v);
+        }
+}
+
+} // ns
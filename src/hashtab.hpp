@@ -0,0 +1,52 @@
+#ifndef HUMBLE_HASHTAB
+#define HUMBLE_HASHTAB
+
+#include "vars.hpp"
+#include <vector>
+#include <utility>
+#include <functional>
+
+namespace humble {
+
+// Table from key to value variable, with open addressing
+// (linear probe) over a power-of-two slot array.  Hash and
+// equality are given so that one type serves both the eq?
+// and the equal? flavour of lookup.
+class HashTable {
+public:
+    typedef size_t (* Hash)(Var & k);
+    typedef bool (* Equal)(Var & a, Var & b);
+    HashTable(Hash hash, Equal equal);
+    EnvEntry get(EnvEntry & k);  // null when absent
+    void set(EnvEntry k, EnvEntry v);
+    bool erase(EnvEntry & k);
+    size_t size() const;
+    std::vector<std::pair<EnvEntry, EnvEntry>> items();
+    // keys and values in place, as for the cycle collector
+    void walk(const std::function<void(EnvEntry &)> & f);
+    // of the same flavour, with keys and values given by f
+    HashTable * copy(const std::function<EnvEntry(EnvEntry &)> & f);
+private:
+    enum { SLOT_FREE, SLOT_USED, SLOT_GONE };
+    struct Slot {
+        EnvEntry k;
+        EnvEntry v;
+        size_t h;
+        int state;
+    };
+    Hash hash;
+    Equal equal;
+    std::vector<Slot> slots;
+    size_t n_used;
+    size_t n_gone;
+    Slot * find(EnvEntry & k, size_t h);
+    void grow();
+};
+
+size_t hash_eqv(Var & k);
+bool eqv_key(Var & k);  // a list becomes cons, as an eq? table key
+size_t hash_equal(Var & k);
+
+} // ns
+
+#endif
@@ -0,0 +1,82 @@
+#include "interp.hpp"
+#include "compx.hpp"
+#include "eval.hpp"
+#include "functions.hpp"
+#include "io_functions.hpp"
+#include "fun_impl.hpp"
+#include "pool.hpp"
+#include <iostream>
+#include <mutex>
+
+using namespace std;
+
+namespace humble {
+
+Interpreter::LocalEnvs::~LocalEnvs() { compx_dispose(v); }
+
+// note: the ext types are set by the first, under the lock
+Interpreter::Interpreter(string dir)
+    : names(init_names())
+    , initial(GlobalEnv::create_t{})
+    , opener(dir)
+    , loader(dir)
+    , env(GlobalEnv::create_t{})
+{
+    static mutex init_mutex;
+    lock_guard<mutex> g(init_mutex);
+    Use u(*this);
+    init_functions(names);
+    io_functions(names);
+    // ^ also serves as example of extension types, VarExt
+    init_macros(macros, names, opener, local_envs);
+    macros[names.intern("requires")] = loader.requires_macro();
+    included = top_included(names, macros, local_envs);
+    macros_init_done(macros);
+    env = initial.init_done();
+}
+
+Interpreter::~Interpreter() { WorkPool::drain(tasks); }
+
+LexForm & Interpreter::compile(const string & src)
+{
+    Use u(*this);
+    auto t = parse(src, names, macros);
+    loader(env, names, cerr);
+    asts.push_back(compx(move(t), names, env.keys(), local_envs));
+    return asts.back();
+}
+
+EnvEntry Interpreter::run(LexForm & ast, ostream * echo)
+{
+    Use u(*this);
+    EnvEntry r = make_var(VarVoid{});
+    for (auto & a : ast.v) {
+        r = humble::run(a, env);
+        if (echo and not holds_alternative<VarVoid>(*r)) {
+            *echo << "; ==> ";
+            print(r, names, *echo);
+            *echo << endl;
+        }
+    }
+    return r;
+}
+
+EnvEntry Interpreter::run(const string & src, ostream * echo)
+{
+    return run(compile(src), echo);
+}
+
+Interpreter::Use::Use(Interpreter & i)
+    : initial(GlobalEnv::use_initial(&i.initial))
+    , names(exchange(u_names, &i.names))
+    , tasks(WorkPool::use_count(&i.tasks))
+{ }
+
+Interpreter::Use::~Use()
+{
+    WorkPool::use_count(tasks);
+    GlobalEnv::use_initial(initial);
+    u_names = names;
+}
+
+} // ns
@@ -0,0 +1,56 @@
+#ifndef HUMBLE_INTERP
+#define HUMBLE_INTERP
+
+#include "top.hpp"
+#include "xdl.hpp"
+#include <list>
+#include <atomic>
+#include <iosfwd>
+
+namespace humble {
+
+// An interpreter with its own names, builtins, macros and toplevel,
+// so that several can be in one process, each on one thread at a
+// time.  The builtins and GlobalEnv::initial take these from the
+// interpreter in use by the thread, which compile and run set.
+struct Interpreter {
+    explicit Interpreter(std::string dir);
+    Interpreter(const Interpreter &) = delete;
+    Interpreter & operator=(const Interpreter &) = delete;
+    ~Interpreter();  // after its spawned tasks
+
+    LexForm & compile(const std::string & src);  // kept while this is
+    EnvEntry run(LexForm & ast, std::ostream * echo = nullptr);  // the last
+    EnvEntry run(const std::string & src, std::ostream * echo = nullptr);
+
+    // note: sets the interpreter of this thread, until destructed
+    struct Use {
+        explicit Use(Interpreter & i);
+        Use(const Use &) = delete;
+        ~Use();
+    private:
+        GlobalEnv * initial;
+        Names * names;
+        std::atomic<size_t> * tasks;
+    };
+
+    struct LocalEnvs {
+        using T = std::vector<LexEnv *>;
+        operator T&() { return v; }
+        ~LocalEnvs();
+        T v;
+    } local_envs;  // note: first, as disposed after the lex trees
+    Names names;
+    GlobalEnv initial;
+    Macros macros;
+    Opener opener;
+    LibLoader loader;
+    LexForm included;
+    std::list<LexForm> asts;
+    GlobalEnv env;
+    std::atomic<size_t> tasks{0};  // note: submitted and not yet run
+};
+
+} // ns
+
+#endif
@@ -3,9 +3,12 @@
 #include "vars.hpp"
 #include "cons.hpp"
 #include "compx.hpp"
+#include "utf.hpp"
+#include "serial.hpp"
 #include "eval.hpp"
 #include "fun_impl.hpp"
 #include "debug.hpp"
+#include "profile.hpp"
 #include <functional>
 #include <sstream>
 #include <fstream>
@@ -19,6 +22,7 @@
 // for misc
 #include <ctime>
 #include <cmath>
+#include <algorithm>
 
 using namespace humble;
 using namespace std;
@@ -100,20 +104,28 @@ void delete_input_file(void * u)
 }
 
 constexpr int MAX_ARGV = 30;
+constexpr int PIPE_BUFFER = 4096;
 
 struct InputPipe {
     int fd;
     int pid;
-    InputPipe(EnvEntry fun)
+    unsigned char b[PIPE_BUFFER];
+    int b_i;
+    int b_n;
+    InputPipe(EnvEntry fun) : b_i(), b_n()
     {
         pipe_fork(fd, pid, fun, 0);
     }
     int get()
     {
+        if (b_i != b_n) return b[b_i++];
         if (fd < 0) return -1;
-        unsigned char r;
-        int i = read(fd, reinterpret_cast<void *>(&r), 1);
-        if (i == 1) return r;
+        int i = read(fd, reinterpret_cast<void *>(b), PIPE_BUFFER);
+        if (i > 0) {
+            b_n = i;
+            b_i = 1;
+            return b[0];
+        }
         if (i) {
             perror("read");
             close(fd);
@@ -293,13 +305,13 @@ int t_prng_state;
 
 EnvEntry make_eof()
 {
-    return make_shared<Var>(VarExt{t_eof_object});
+    return make_var(VarExt{t_eof_object});
 }
 
 EnvEntry f_eof_objectp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("eof-object? argc");
-    return make_shared<Var>(VarBool{
+    return make_var(VarBool{
             holds_alternative<VarExt>(*args[0])
             and get<VarExt>(*args[0]).t == t_eof_object});
 }
@@ -308,9 +320,9 @@ EnvEntry f_portp(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("port? argc");
     if (not holds_alternative<VarExt>(*args[0]))
-        return make_shared<Var>(VarBool{false});
+        return make_var(VarBool{false});
     auto t = get<VarExt>(*args[0]).t;
-    return make_shared<Var>(VarBool{
+    return make_var(VarBool{
             t == t_eof_object
             or t == t_input_string
             or t == t_input_file
@@ -332,6 +344,48 @@ string get_line(int k, function<int()> get)
     return r;
 }
 
+// note: a field is quoted when it starts with the quote, and in it
+//       two quotes make one, while delimiter and newline are kept.
+//       a blank line gives no fields.
+template <typename G>
+bool get_csv_row(G get, int delim, int quote, vector<string> & r)
+{
+    int k = get();
+    if (k < 0) return false;
+    string f;
+    bool quoted = false;
+    bool touched = false;  // by a quote, so not blank
+    size_t kept = 0;  // of f, that was quoted
+    for (;;) {
+        if (quoted) {
+            if (k < 0) throw RunError("read-csv-row end in quote");
+            if (k == quote) {
+                k = get();
+                if (k != quote) {
+                    quoted = false;
+                    kept = f.size();
+                    continue;
+                }
+            }
+            f.push_back(k);
+        } else if (k == quote and f.empty()) {
+            quoted = touched = true;
+        } else if (k == delim) {
+            r.push_back(move(f));
+            f.clear();
+            kept = 0;
+        } else if (k == '\n' or k < 0) {
+            if (f.size() > kept and f.back() == '\r') f.pop_back();
+            if (touched or not r.empty() or not f.empty())
+                r.push_back(move(f));
+            return true;
+        } else {
+            f.push_back(k);
+        }
+        k = get();
+    }
+}
+
 string get_to_eof(function<int()> get)
 {
     string r;
@@ -348,13 +402,13 @@ EnvEntry f_open_input_string(span<EnvEntry> args)
     auto r = VarExt{t_input_string};
     r.u = new InputString{get<VarString>(*args[0]).s};
     r.f = delete_input_string;
-    return make_shared<Var>(move(r));
+    return make_var(move(r));
 }
 
 EnvEntry f_open_input_string_bytes(span<EnvEntry> args)
 {
     if (args.size() != 1) throw RunError("o-i-s-b argc");
-    valt_or_fail<VarCons, VarList>(args, 0, "o-i-s-b");
+    valt_or_fail<VarCons, VarList, VarView>(args, 0, "o-i-s-b");
     auto j = make_iter(*args[0]);
     string s;
     for (;;) {
@@ -368,7 +422,7 @@ EnvEntry f_open_input_string_bytes(span<EnvEntry> args)
     auto r = VarExt{t_input_string};
     r.u = new InputString{s};
     r.f = delete_input_string;
-    return make_shared<Var>(move(r));
+    return make_var(move(r));
 }
 
 EnvEntry f_open_input_file(span<EnvEntry> args)
@@ -379,8 +433,8 @@ EnvEntry f_open_input_file(span<EnvEntry> args)
     auto p = new InputFile{get<VarString>(*args[0]).s};
     r.u = p;
     r.f = delete_input_file;
-    if (not p->ifs) return make_shared<Var>(VarBool{false});
-    return make_shared<Var>(move(r));
+    if (not p->ifs) return make_var(VarBool{false});
+    return make_var(move(r));
 }
 
 EnvEntry f_with_input_pipe(span<EnvEntry> args)
@@ -389,14 +443,14 @@ EnvEntry f_with_input_pipe(span<EnvEntry> args)
     valt_or_fail<VarFunHost, VarFunOps>(args, 0, "with-input-pipe");
     valt_or_fail<VarFunHost, VarFunOps>(args, 1, "with-input-pipe");
     auto p = new InputPipe{args[0]};
-    auto k = make_shared<Var>(VarExt{t_input_pipe});
+    auto k = make_var(VarExt{t_input_pipe});
     get<VarExt>(*k).u = p;
     get<VarExt>(*k).f = delete_input_pipe;
     vector<EnvEntry> x{args[1], k};
     auto y = fun_call(x);
     int status = p->done();
-    vector<EnvEntry> v{make_shared<Var>(VarNum{status}), y};
-    return make_shared<Var>(VarNonlist{move(v)});
+    vector<EnvEntry> v{make_var(VarNum{status}), y};
+    return make_var(VarNonlist{move(v)});
 }
 
 EnvEntry f_pipe_system_input(span<EnvEntry> args)
@@ -407,7 +461,7 @@ EnvEntry f_pipe_system_input(span<EnvEntry> args)
     int pid;
     pipe_fork(fd, pid, args[0], 0);
     dup2(fd, 0);
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_read_byte(span<EnvEntry> args)
@@ -427,7 +481,7 @@ EnvEntry f_read_byte(span<EnvEntry> args)
         k = read_byte(*static_cast<ifstream *>(e.u));
     else abort();
     if (k < 0) return make_eof();
-    return make_shared<Var>(VarNum{k});
+    return make_var(VarNum{k});
 }
 
 #define TC_GET_LINE(T, C, G) (e.t == T)           \
@@ -447,10 +501,11 @@ EnvEntry f_read_line(span<EnvEntry> args)
     else if TC_GET_LINE(t_input_pipe, InputPipe *, p->get())
     else if TC_GET_LINE(t_input_sys, ifstream *, read_byte(*p))
     else abort();
-    return make_shared<Var>(VarString{r});
+    if (not utf_valid(r)) throw RunError("read-line not utf8");
+    return make_var(VarString{r});
 }
 
-#define TC_GET_TO_EOF(T, C, G) (e.t == t_input_string) \
+#define TC_GET_TO_EOF(T, C, G) (e.t == T)              \
     {   auto p = static_cast<C>(e.u);                  \
         r = get_to_eof([&p](){ return G; }); }
 
@@ -466,7 +521,48 @@ EnvEntry f_read_to_eof(span<EnvEntry> args)
     else if TC_GET_TO_EOF(t_input_pipe, InputPipe *, p->get())
     else if TC_GET_TO_EOF(t_input_sys, ifstream *, read_byte(*p))
     else abort();
-    return make_shared<Var>(VarString{r});
+    if (not utf_valid(r)) throw RunError("read-to-eof not utf8");
+    return make_var(VarString{r});
+}
+
+#define TC_GET_CSV_ROW(T, C, G) (e.t == T)                         \
+    {   auto p = static_cast<C>(e.u);                              \
+        if (not get_csv_row([&p](){ return G; }, delim, quote, r)) \
+            return make_eof(); }
+
+int csv_char_or_fail(span<EnvEntry> args, size_t i)
+{
+    valt_or_fail<VarNum>(args, i, "read-csv-row");
+    auto c = get<VarNum>(*args[i]).i;
+    if (c < 0 or c >= 0x80 or c == '\n' or c == '\r')
+        throw RunError("read-csv-row expects ascii delimiter and quote");
+    return c;
+}
+
+EnvEntry f_read_csv_row(span<EnvEntry> args)
+{
+    if (args.empty() or args.size() > 3)
+        throw RunError("read-csv-row argc");
+    auto & e = vext_or_fail(
+            {t_input_string, t_input_file, t_input_pipe, t_input_sys},
+            args, 0, "read-csv-row");
+    int delim = args.size() >= 2 ? csv_char_or_fail(args, 1) : ',';
+    int quote = args.size() >= 3 ? csv_char_or_fail(args, 2) : '"';
+    if (delim == quote) throw RunError("read-csv-row delimiter is quote");
+    vector<string> r;
+    if TC_GET_CSV_ROW(t_input_string, InputString *, p->get())
+    else if TC_GET_CSV_ROW(t_input_file, InputFile *, p->get())
+    else if TC_GET_CSV_ROW(t_input_pipe, InputPipe *, p->get())
+    else if TC_GET_CSV_ROW(t_input_sys, ifstream *, read_byte(*p))
+    else abort();
+    vector<EnvEntry> v;
+    v.reserve(r.size());
+    for (auto & f : r) {
+        if (not utf_valid(f)) throw RunError("read-csv-row not utf8");
+        v.push_back(make_var(VarString{move(f)}));
+    }
+    if (v.empty()) return make_var(VarCons{});
+    return make_var(VarList{move(v)});
 }
 
 EnvEntry f_open_output_string(span<EnvEntry> args)
@@ -475,7 +571,7 @@ EnvEntry f_open_output_string(span<EnvEntry> args)
     auto r = VarExt{t_output_string};
     r.u = new OutputString{};
     r.f = delete_output_string;
-    return make_shared<Var>(move(r));
+    return make_var(move(r));
 }
 
 EnvEntry f_output_string_get(span<EnvEntry> args)
@@ -483,7 +579,7 @@ EnvEntry f_output_string_get(span<EnvEntry> args)
     if (args.size() != 1) throw RunError("output-string-get argc");
     auto & e = vext_or_fail({t_output_string}, args, 0, "output-string-get");
     auto p = static_cast<OutputString *>(e.u);
-    return make_shared<Var>(VarString{p->s});
+    return make_var(VarString{p->s});
 }
 
 EnvEntry f_output_string_get_bytes(span<EnvEntry> args)
@@ -494,9 +590,9 @@ EnvEntry f_output_string_get_bytes(span<EnvEntry> args)
     vector<EnvEntry> r;
     for (auto i : p->s) {
         int u = static_cast<unsigned char>(i);
-        r.push_back(make_shared<Var>(VarNum{u}));
+        r.push_back(make_var(VarNum{u}));
     }
-    return make_shared<Var>(VarList{move(r)});
+    return make_var(VarList{move(r)});
 }
 
 EnvEntry f_open_output_file(span<EnvEntry> args)
@@ -507,8 +603,8 @@ EnvEntry f_open_output_file(span<EnvEntry> args)
     auto p = new OutputFile{get<VarString>(*args[0]).s};
     r.u = p;
     r.f = delete_output_file;
-    if (not p->ofs) return make_shared<Var>(VarBool{false});
-    return make_shared<Var>(move(r));
+    if (not p->ofs) return make_var(VarBool{false});
+    return make_var(move(r));
 }
 
 EnvEntry f_with_output_pipe(span<EnvEntry> args)
@@ -517,14 +613,14 @@ EnvEntry f_with_output_pipe(span<EnvEntry> args)
     valt_or_fail<VarFunHost, VarFunOps>(args, 0, "with-output-pipe");
     valt_or_fail<VarFunHost, VarFunOps>(args, 1, "with-output-pipe");
     auto p = new OutputPipe{args[0]};
-    auto k = make_shared<Var>(VarExt{t_output_pipe});
+    auto k = make_var(VarExt{t_output_pipe});
     get<VarExt>(*k).u = p;
     get<VarExt>(*k).f = delete_output_pipe;
     vector<EnvEntry> x{args[1], k};
     auto y = fun_call(x);
     int status = p->done();
-    vector<EnvEntry> v{make_shared<Var>(VarNum{status}), y};
-    return make_shared<Var>(VarNonlist{move(v)});
+    vector<EnvEntry> v{make_var(VarNum{status}), y};
+    return make_var(VarNonlist{move(v)});
 }
 
 EnvEntry f_pipe_system_output(span<EnvEntry> args)
@@ -536,7 +632,7 @@ EnvEntry f_pipe_system_output(span<EnvEntry> args)
     pipe_fork(fd, pid, args[0], 1);
     cout.flush();
     dup2(fd, 1);
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_write_byte(span<EnvEntry> args)
@@ -556,17 +652,11 @@ EnvEntry f_write_byte(span<EnvEntry> args)
     else if (e.t == t_output_sys)
         write_byte(*static_cast<ofstream *>(e.u), i);
     else abort();
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
-EnvEntry f_write_string(span<EnvEntry> args)
+void put_string(VarExt & e, const string & s)
 {
-    if (args.size() != 2) throw RunError("write-string argc");
-    valt_or_fail<VarString>(args, 0, "write-string");
-    auto & e = vext_or_fail(
-            {t_output_string, t_output_file, t_output_pipe, t_output_sys},
-            args, 1, "write-string");
-    const string & s = get<VarString>(*args[0]).s;
     if (e.t == t_output_string)
         static_cast<OutputString *>(e.u)->put(s);
     else if (e.t == t_output_file)
@@ -576,7 +666,49 @@ EnvEntry f_write_string(span<EnvEntry> args)
     else if (e.t == t_output_sys)
         write_str(*static_cast<ofstream *>(e.u), s);
     else abort();
-    return make_shared<Var>(VarVoid{});
+}
+
+EnvEntry f_write_string(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("write-string argc");
+    valt_or_fail<VarString>(args, 0, "write-string");
+    auto & e = vext_or_fail(
+            {t_output_string, t_output_file, t_output_pipe, t_output_sys},
+            args, 1, "write-string");
+    put_string(e, get<VarString>(*args[0]).s);
+    return make_var(VarVoid{});
+}
+
+EnvEntry f_serialize(span<EnvEntry> args)
+{
+    if (args.size() != 2) throw RunError("serialize argc");
+    auto & e = vext_or_fail(
+            {t_output_string, t_output_file, t_output_pipe, t_output_sys},
+            args, 1, "serialize");
+    string s;
+    serial_write(args[0], *u_names, s);
+    put_string(e, s);
+    return make_var(VarVoid{});
+}
+
+#define TC_SERIAL_READ(T, C, G) (e.t == T)                \
+    {   auto p = static_cast<C>(e.u);                     \
+        r = serial_read([&p](){ return G; }, *u_names); }
+
+EnvEntry f_deserialize(span<EnvEntry> args)
+{
+    if (args.size() != 1) throw RunError("deserialize argc");
+    auto & e = vext_or_fail(
+            {t_input_string, t_input_file, t_input_pipe, t_input_sys},
+            args, 0, "deserialize");
+    EnvEntry r;
+    if TC_SERIAL_READ(t_input_string, InputString *, p->get())
+    else if TC_SERIAL_READ(t_input_file, InputFile *, p->get())
+    else if TC_SERIAL_READ(t_input_pipe, InputPipe *, p->get())
+    else if TC_SERIAL_READ(t_input_sys, ifstream *, read_byte(*p))
+    else abort();
+    if (not r) return make_eof();
+    return r;
 }
 
 EnvEntry f_clock(span<EnvEntry> args)
@@ -584,10 +716,11 @@ EnvEntry f_clock(span<EnvEntry> args)
     if (args.size() != 0) throw RunError("clock argc");
     time_t r;
     (void)time(&r);
-    return make_shared<Var>(VarNum{r});
+    return make_var(VarNum{r});
 }
 
 constexpr long long JIFFIES_PER_SECOND = 1000;
+constexpr long long TIME_IT_RUNS = 10000000;  // of times kept, at most
 static timespec u_zt;
 
 EnvEntry f_current_jiffy(span<EnvEntry> args)
@@ -603,7 +736,71 @@ EnvEntry f_current_jiffy(span<EnvEntry> args)
                 + 1e-9 * double(ts.tv_nsec - u_zt.tv_nsec))
             * JIFFIES_PER_SECOND;
     }
-    return make_shared<Var>(VarNum{r});
+    return make_var(VarNum{r});
+}
+
+long long clock_ns(clockid_t c)
+{
+    timespec ts{};
+    (void)clock_gettime(c, &ts);
+    return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+EnvEntry f_current_monotonic_ns(span<EnvEntry> args)
+{
+    if (args.size() != 0) throw RunError("current-monotonic-ns argc");
+    return make_var(VarNum{clock_ns(CLOCK_MONOTONIC)});
+}
+
+EnvEntry f_current_cpu_ns(span<EnvEntry> args)
+{
+    if (args.size() != 0) throw RunError("current-cpu-ns argc");
+    return make_var(VarNum{clock_ns(CLOCK_PROCESS_CPUTIME_ID)});
+}
+
+// note: the times are kept in a vector made before the runs, and
+//       the call vector is reused, so that a run is only the call.
+EnvEntry f_time_it(span<EnvEntry> args)
+{
+    if (args.size() != 2 and args.size() != 3)
+        throw RunError("time-it argc");
+    valt_or_fail<VarFunHost, VarFunOps>(args, 0, "time-it");
+    valt_or_fail<VarNum>(args, 1, "time-it");
+    long long n = get<VarNum>(*args[1]).i;
+    long long warmup{};
+    if (args.size() == 3) {
+        valt_or_fail<VarNum>(args, 2, "time-it");
+        warmup = get<VarNum>(*args[2]).i;
+    }
+    if (n <= 0 or n > TIME_IT_RUNS) throw RunError("time-it runs");
+    if (warmup < 0) throw RunError("time-it warmup");
+    vector<EnvEntry> x{args[0]};
+    for (long long i = 0; i < warmup; ++i) {
+        x[0] = args[0];
+        (void)fun_call(x);
+    }
+    vector<long long> t(n);
+    for (auto & d : t) {
+        x[0] = args[0];
+        auto s = clock_ns(CLOCK_MONOTONIC);
+        (void)fun_call(x);
+        d = clock_ns(CLOCK_MONOTONIC) - s;
+    }
+    long long sum{};
+    for (auto d : t) sum += d;
+    sort(t.begin(), t.end());
+    vector<EnvEntry> r;
+    auto add = [&r](const string & s, long long i) {
+        vector<EnvEntry> p{make_var(VarNam{u_names->intern(s)}),
+                make_var(VarNum{i})};
+        r.push_back(make_var(VarNonlist{move(p)}));
+    };
+    add("runs", n);
+    add("min", t.front());
+    add("median", t[n / 2]);
+    add("mean", sum / n);
+    add("max", t.back());
+    return make_var(VarList{move(r)});
 }
 
 EnvEntry f_pause(span<EnvEntry> args)
@@ -620,7 +817,7 @@ EnvEntry f_pause(span<EnvEntry> args)
                 and errno == EINTR)
             ts = rem;
     }
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 EnvEntry f_make_prng_state(span<EnvEntry> args)
@@ -631,7 +828,7 @@ EnvEntry f_make_prng_state(span<EnvEntry> args)
     auto r = VarExt{t_prng_state};
     r.u = new PrngState(seed);
     r.f = delete_prng_state;
-    return make_shared<Var>(move(r));
+    return make_var(move(r));
 }
 
 EnvEntry f_prng_get(span<EnvEntry> args)
@@ -640,7 +837,7 @@ EnvEntry f_prng_get(span<EnvEntry> args)
     auto & e = vext_or_fail({t_prng_state}, args, 0, "prng-get");
     int32_t result;
     (void)random_r(&static_cast<PrngState *>(e.u)->buf, &result);
-    return make_shared<Var>(VarNum{result});
+    return make_var(VarNum{result});
 }
 
 vector<string> u_system_command_line;
@@ -650,9 +847,9 @@ EnvEntry f_system_command_line(span<EnvEntry> args)
     if (args.size() != 0) throw RunError("system-command-line argc");
     vector<EnvEntry> result;
     for (auto & s : u_system_command_line) {
-        result.push_back(make_shared<Var>(VarString{s}));
+        result.push_back(make_var(VarString{s}));
     }
-    return make_shared<Var>(VarList{result});
+    return make_var(VarList{result});
 }
 
 EnvEntry f_system_input_port(span<EnvEntry> args)
@@ -660,7 +857,7 @@ EnvEntry f_system_input_port(span<EnvEntry> args)
     if (args.size() != 0) throw RunError("system-input-port argc");
     auto r = VarExt{t_input_sys};
     r.u = &cin;
-    return make_shared<Var>(r);
+    return make_var(r);
 }
 
 EnvEntry f_system_output_port(span<EnvEntry> args)
@@ -668,7 +865,7 @@ EnvEntry f_system_output_port(span<EnvEntry> args)
     if (args.size() != 0) throw RunError("system-output-port argc");
     auto r = VarExt{t_output_sys};
     r.u = &cout;
-    return make_shared<Var>(r);
+    return make_var(r);
 }
 
 EnvEntry f_system_error_port(span<EnvEntry> args)
@@ -676,7 +873,7 @@ EnvEntry f_system_error_port(span<EnvEntry> args)
     if (args.size() != 0) throw RunError("system-error-port argc");
     auto r = VarExt{t_output_sys};
     r.u = &cerr;
-    return make_shared<Var>(r);
+    return make_var(r);
 }
 
 EnvEntry f_exec_command(span<EnvEntry> args)
@@ -693,7 +890,7 @@ EnvEntry f_exec_command(span<EnvEntry> args)
     }
     execvp(argv[0], argv);
     _Exit(1);
-    return make_shared<Var>(VarVoid{});
+    return make_var(VarVoid{});
 }
 
 } // ans
@@ -711,16 +908,16 @@ void io_functions(Names & n)
     if (u_names and u_names != &n)
         throw CoreError("io_functions on separate intern");
     u_names = &n;
-    t_eof_object = n.intern("eof-object");
-    t_input_string = n.intern("input-string");
-    t_input_file = n.intern("input-file");
-    t_input_pipe = n.intern("input-pipe");
-    t_input_sys = n.intern("system-input");
-    t_output_string = n.intern("output-string");
-    t_output_file = n.intern("output-file");
-    t_output_pipe = n.intern("output-pipe");
-    t_output_sys = n.intern("system-output");
-    t_prng_state = n.intern("prng-state");
+    ext_type(t_eof_object, n, "eof-object");
+    ext_type(t_input_string, n, "input-string");
+    ext_type(t_input_file, n, "input-file");
+    ext_type(t_input_pipe, n, "input-pipe");
+    ext_type(t_input_sys, n, "system-input");
+    ext_type(t_output_string, n, "output-string");
+    ext_type(t_output_file, n, "output-file");
+    ext_type(t_output_pipe, n, "output-pipe");
+    ext_type(t_output_sys, n, "system-output");
+    ext_type(t_prng_state, n, "prng-state");
     auto & g = GlobalEnv::initial();
     typedef EnvEntry (*hp)(span<EnvEntry> args);
     for (auto & p : initializer_list<pair<string, hp>>{
@@ -734,6 +931,7 @@ void io_functions(Names & n)
             { "read-byte", f_read_byte },
             { "read-line", f_read_line },
             { "read-to-eof", f_read_to_eof},
+            { "read-csv-row", f_read_csv_row },
             { "open-output-string", f_open_output_string },
             { "open-output-file", f_open_output_file },
             { "with-output-pipe", f_with_output_pipe },
@@ -743,8 +941,13 @@ void io_functions(Names & n)
             { "output-string-get-bytes", f_output_string_get_bytes },
             { "write-byte", f_write_byte },
             { "write-string", f_write_string },
+            { "serialize", f_serialize },
+            { "deserialize", f_deserialize },
             { "clock", f_clock },
             { "current-jiffy", f_current_jiffy },
+            { "current-monotonic-ns", f_current_monotonic_ns },
+            { "current-cpu-ns", f_current_cpu_ns },
+            { "time-it", f_time_it },
             { "pause", f_pause },
             { "make-prng-state", f_make_prng_state },
             { "prng-get", f_prng_get },
@@ -752,7 +955,10 @@ void io_functions(Names & n)
             { "pipe-system-input", f_pipe_system_input },
             { "pipe-system-output", f_pipe_system_output },
             { "exec-command", f_exec_command },
-    }) g.set(n.intern(p.first), make_shared<Var>(VarFunHost{ p.second }));
+    }) g.set(n.intern(p.first), make_var(VarFunHost{ p.second }));
+    for (auto p : { f_read_byte, f_read_line, f_read_to_eof, f_read_csv_row,
+            f_write_byte, f_write_string, f_serialize, f_deserialize })
+        trace_io(p);
 }
 
 } // ns
@@ -347,7 +347,7 @@ struct UserMacro : MacroNotClone<UserMacro>
             if (args.size() < last) throw SrcError("user-macro dot argc");
             for (size_t i = 0; i != last; ++i)
                 env.set(parms[i], args[i]);
-            env.set(parms[last], make_shared<Var>(
+            env.set(parms[last], make_var(
                         VarList{{args.begin() + last, args.end()}}));
         } else {
             if (args.size() != parms.size())
@@ -658,18 +658,21 @@ struct Scope : MacroClone<Scope> {
     }
 };
 
-Macros i_macros;
-
+// note: an imported file is parsed with the macros there were at
+//       init done, of the interpreter, shared by the nested imports.
 struct Import : MacroNotClone<Import> {
     Names * names;
     Macros * macros;
     SrcOpener * opener;
     vector<LexEnv *> * local_envs;
-    Import(Names & names, Macros & macros, SrcOpener & opener, vector<LexEnv *> & local_envs)
+    shared_ptr<Macros> i_macros;
+    Import(Names & names, Macros & macros, SrcOpener & opener,
+            vector<LexEnv *> & local_envs, shared_ptr<Macros> i_macros)
         : names(&names)
         , macros(&macros)
         , opener(&opener)
         , local_envs(&local_envs)
+        , i_macros(i_macros)
     { }
 
 private:
@@ -688,9 +691,10 @@ public:
         auto u_fn = opener->filename;
         if (s.v.size() != 2 and s.v.size() != 3) throw SrcError("import argc");
         malt_or_fail<LexString>(s.v[1], "import.1 expects name");
-        auto e_macros = clone_macros(i_macros);
+        auto e_macros = clone_macros(*i_macros);
         e_macros[NAM_MACRO] = make_unique<MacroMacro>(*names, e_macros, *local_envs);
-        e_macros[NAM_IMPORT] = make_unique<Import>(*names, e_macros, *opener, *local_envs);
+        e_macros[NAM_IMPORT] = make_unique<Import>(*names, e_macros, *opener,
+                *local_envs, i_macros);
         auto src = (*opener)(get<LexString>(s.v[1]).s);
         auto u_ln = linenumber;
         auto r = compx(parse(src, *names, e_macros), *names,
@@ -794,7 +798,8 @@ void init_macros(Macros & m, Names & names, SrcOpener & opener, vector<LexEnv *>
 {
     m = qt_macros();
     m[NAM_MACRO] = make_unique<MacroMacro>(names, m, local_envs);
-    m[NAM_IMPORT] = make_unique<Import>(names, m, opener, local_envs);
+    m[NAM_IMPORT] = make_unique<Import>(names, m, opener, local_envs,
+            make_shared<Macros>());
     with_name(names, m, "lambda", make_unique<Lambda>());
     with_name(names, m, "let", make_unique<Let>());
     with_name(names, m, "let*", make_unique<Letx>());
@@ -819,7 +824,9 @@ void init_macros(Macros & m, Names & names, SrcOpener & opener, vector<LexEnv *>
 
 void macros_init_done(Macros & macros)
 {
-    i_macros = clone_macros(macros);
+    auto i = dynamic_cast<Import *>(macros.at(NAM_IMPORT).get());
+    if (not i) throw CoreError("init done without import");
+    *i->i_macros = clone_macros(macros);
 }
 
 } // ns
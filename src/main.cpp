@@ -1,14 +1,11 @@
-#include "compx.hpp"
-#include "eval.hpp"
-#include "top.hpp"
-#include "xdl.hpp"
-#include "functions.hpp"
+#include "interp.hpp"
 #include "io_functions.hpp"
 #include "except.hpp"
+#include "profile.hpp"
 #include <fstream>
 #include <iostream>
-#include <list>
 #include <cstring>
+#include <chrono>
 
 using namespace humble;
 using namespace std;
@@ -21,77 +18,116 @@ void errout(const string & ty, const string & wh, const string & fn)
     cerr << ",\n" << wh << endl;
 }
 
-void run_top(LexForm & ast, string src, Names & names, Macros & macros,
-        GlobalEnv & env, string & fn, vector<LexEnv *> & local_envs, LibLoader & loader)
+void run_top(Interpreter & h, const string & src)
     try
 {
-    auto t = parse(src, names, macros);
-    loader(env, names, cerr);
-    ast = compx(move(t), names, env.keys(), local_envs);
-    auto & os = cout;
-    for (auto & a : ast.v) {
-        auto r = run(a, env);
-        if (not holds_alternative<VarVoid>(*r)) {
-            os << "; ==> ";
-            print(r, names, os);
-            os << endl;
-        }
-    }
+    h.run(src, &cout);
 } catch (const SrcError & e) {
-    errout("src-error", e.what(), fn);
+    errout("src-error", e.what(), h.opener.filename);
 } catch (const RunError & e) {
-    errout("run-error", e.what(), fn);
+    errout("run-error", e.what(), h.opener.filename);
 } catch (const runtime_error & e) {
-    errout("error", e.what(), fn);
+    errout("error", e.what(), h.opener.filename);
+}
+
+constexpr int PROFILE_HZ = 1000;
+
+chrono::steady_clock::time_point t_start;
+
+void print_heap_stats()
+{
+    auto c = heap_stats();
+    chrono::duration<double> t = chrono::steady_clock::now() - t_start;
+    cerr << "heap-stats:\n";
+    for (int k = 0; k != HEAP_KINDS; ++k)
+        cerr << "  " << heap_kind_name(k) << " made " << c.made[k]
+            << " live " << c.made[k] - c.freed[k] << "\n";
+    cerr << "  bytes " << c.bytes << " peak " << c.peak
+        << " pool " << c.pool_bytes << "\n";
+    cerr << "  seconds " << t.count() << " vars per second "
+        << static_cast<long long>(c.made[HEAP_VAR] / t.count()) << "\n";
+    for (size_t i = 0; i != variant_size_v<Var>; ++i)
+        if (c.var_made[i])
+            cerr << "  " << var_type_name(i) << " made " << c.var_made[i]
+                << "\n";
 }
 
 int main(int argc, char ** argv)
 {
+    t_start = chrono::steady_clock::now();
+    // note: options are taken off before the script sees the rest
+    string profile_fn;
+    bool count = false;
+    string count_fn;  // note: empty for stderr
+    string trace_fn;
+    while (argc >= 2 and strncmp(argv[1], "--", 2) == 0) {
+        if (strcmp(argv[1], "--stats") == 0) {
+            atexit(print_heap_stats);
+        } else if (strcmp(argv[1], "--count") == 0) {
+            count = true;
+        } else if (strncmp(argv[1], "--count=", 8) == 0) {
+            count = true;
+            count_fn = argv[1] + 8;
+        } else if (strcmp(argv[1], "--trace") == 0) {
+            trace_fn = "trace.json";
+        } else if (strncmp(argv[1], "--trace=", 8) == 0) {
+            trace_fn = argv[1] + 8;
+        } else if (strcmp(argv[1], "--profile") == 0) {
+            profile_fn = "profile.folded";
+        } else if (strncmp(argv[1], "--profile=", 10) == 0) {
+            profile_fn = argv[1] + 10;
+        } else {
+            cerr << "unknown option " << argv[1] << endl;
+            return 2;
+        }
+        argv[1] = argv[0];
+        ++argv;
+        --argc;
+    }
+
     string dir = "/usr/share/humble";
     if (char * d = getenv("HUMBLE_DIR"); d) dir = d;
 
-    struct LocalEnvs {
-        using T = vector<LexEnv *>;
-        operator T&() { return v; }
-        ~LocalEnvs() { compx_dispose(v); }
-        T v;
-    } local_envs;
-
-    Names names = init_names();
-    init_functions(names);
-    io_functions(names);
-    // ^ also serves as example of extension types, VarExt
+    Interpreter h{ dir };
+    Interpreter::Use use{ h };
+    // ^ also for the names of the builtins at stop of profile
     io_set_system_command_line(argc, argv);
-
-    Macros macros;
-    Opener opener{ dir };
-    init_macros(macros, names, opener, local_envs);
-    LibLoader loader{ dir };
-    macros[names.intern("requires")] = loader.requires_macro();
-    top_included(names, macros, local_envs);
-    macros_init_done(macros);
-    auto env = GlobalEnv::initial().init_done();
+    auto & names = h.names;
+    if (not profile_fn.empty()) {
+        profile_start(profile_fn, names, PROFILE_HZ);
+        atexit(profile_stop);
+    }
+    if (count) {
+        count_start(count_fn, names);
+        atexit(count_stop);
+    }
+    if (not trace_fn.empty()) {
+        trace_start(trace_fn, names);
+        atexit(trace_stop);
+    }
 
     if (argc >= 2) {
         char * fn = argv[1];
-        auto src = opener(fn, Opener::noresolve);
-        LexForm ast;
-        run_top(ast, src, names, macros, env, opener.filename, local_envs, loader);
+        run_top(h, h.opener(fn, Opener::noresolve));
+        profile_stop();  // note: while the lambdas are there
+        count_stop();
+        trace_stop();
         return 0;
     }
 
     cout << "WELCOME TO HUMBLE SCHEME.  please enter an expression and then\n"
         "use a ';' character at EOL to evaluate or EOF indication to exit\n";
-    list<LexForm> x;
     std::string line, buf;
     while (std::getline(cin, line)) {
         buf += line + "\n";
         if (line.back() == ';') {
-            x.push_back(LexForm{});
-            run_top(x.back(), buf, names, macros, env, opener.filename, local_envs, loader);
+            run_top(h, buf);
             buf.clear();
         }
     }
+    profile_stop();
+    count_stop();
+    trace_stop();
     cout << "\nfare well.\n";
 }
 
@@ -0,0 +1,184 @@
+#include "pool.hpp"
+#include "vars.hpp"
+#include "fun_impl.hpp"
+#include <chrono>
+
+using namespace std;
+
+namespace humble {
+
+namespace {
+
+atomic<WorkPool *> shared_made;
+thread_local WorkPool * w_pool;
+thread_local size_t w_index;
+thread_local atomic<size_t> * u_count;
+
+// note: as of the thread that submits, while the task runs, and
+//       the count is let go of once it has
+struct UseOf {
+    Names * names;
+    GlobalEnv * initial;
+    atomic<size_t> * count;
+    UseOf(Names * n, GlobalEnv * e, atomic<size_t> * c)
+        : names(exchange(u_names, n))
+        , initial(GlobalEnv::use_initial(e))
+        , count(exchange(u_count, c))
+    { }
+    ~UseOf()
+    {
+        if (u_count) --*u_count;
+        u_count = count;
+        GlobalEnv::use_initial(initial);
+        u_names = names;
+    }
+};
+
+} // ans
+
+WorkPool::WorkPool(size_t n)
+    : queued{0}
+    , busy{0}
+    , next{0}
+    , stop{false}
+{
+    for (size_t i = 0; i != n; ++i)
+        queues.push_back(make_unique<Queue>());
+    for (size_t i = 0; i != n; ++i)
+        threads.emplace_back(&WorkPool::work, this, i);
+}
+
+// note: a worker may end the process, as by exit in a task
+WorkPool::~WorkPool()
+{
+    {
+        lock_guard<mutex> g(m);
+        stop = true;
+    }
+    more.notify_all();
+    for (auto & t : threads)
+        if (t.get_id() == this_thread::get_id()) t.detach();
+        else t.join();
+}
+
+void WorkPool::submit(Task t)
+{
+    if (u_count) ++*u_count;
+    Task u = [n = u_names, e = &GlobalEnv::initial(), c = u_count,
+            t = move(t)] {
+        UseOf o(n, e, c);
+        t();
+    };
+    size_t i;
+    if (w_pool == this) {
+        i = w_index;
+    } else {
+        lock_guard<mutex> g(m);
+        i = next++ % queues.size();
+    }
+    {
+        lock_guard<mutex> g(m);
+        ++queued;  // note: before, so that a take never goes below 0
+        ++busy;
+    }
+    {
+        lock_guard<mutex> g(queues[i]->m);
+        queues[i]->q.push_back(move(u));
+    }
+    more.notify_one();
+}
+
+// note: own newest first, as its data is likely still in cache,
+//       and else the oldest of another, as likely the largest
+bool WorkPool::take(size_t i, Task & t)
+{
+    size_t n = queues.size();
+    if (i < n) {
+        auto & q = *queues[i];
+        lock_guard<mutex> g(q.m);
+        if (not q.q.empty()) {
+            t = move(q.q.back());
+            q.q.pop_back();
+            --queued;
+            return true;
+        }
+    }
+    for (size_t k = 1; k <= n; ++k) {
+        auto & q = *queues[(i + k) % n];
+        lock_guard<mutex> g(q.m);
+        if (not q.q.empty()) {
+            t = move(q.q.front());
+            q.q.pop_front();
+            --queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkPool::run(Task & t)
+{
+    t();
+    t = nullptr;
+    --busy;
+    {
+        lock_guard<mutex> g(m);
+    }
+    done.notify_all();
+}
+
+bool WorkPool::run_one()
+{
+    Task t;
+    if (not take(w_pool == this ? w_index : queues.size(), t))
+        return false;
+    run(t);
+    return true;
+}
+
+void WorkPool::wait(const atomic<size_t> & left)
+{
+    while (left) {
+        if (run_one()) continue;
+        unique_lock<mutex> l(m);
+        done.wait_for(l, chrono::milliseconds(1),
+                [&] { return left == 0 or queued != 0; });
+    }
+}
+
+void WorkPool::work(size_t i)
+{
+    w_pool = this;
+    w_index = i;
+    Task t;
+    for (;;) {
+        if (take(i, t)) {
+            run(t);
+            continue;
+        }
+        unique_lock<mutex> l(m);
+        more.wait(l, [this] { return stop or queued != 0; });
+        if (stop and queued == 0) return;
+    }
+}
+
+WorkPool & WorkPool::shared()
+{
+    static WorkPool p(max(1u, thread::hardware_concurrency()));
+    shared_made = &p;
+    return p;
+}
+
+atomic<size_t> * WorkPool::use_count(atomic<size_t> * c)
+{
+    return exchange(u_count, c);
+}
+
+// note: not on a worker, as it would wait for its own task
+void WorkPool::drain(const atomic<size_t> & c)
+{
+    auto p = shared_made.load();
+    if (p and w_pool != p) p->wait(c);
+}
+
+} // ns
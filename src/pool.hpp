@@ -0,0 +1,56 @@
+#ifndef HUMBLE_POOL
+#define HUMBLE_POOL
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+namespace humble {
+
+// Threads that run tasks, each from a deque of its own.  A task
+// submitted on a worker goes to its own deque, where the worker
+// takes the newest first, and one that has none takes the oldest
+// of another.  The names and initial env of the thread that
+// submits are those in use when the task is run, and so is the
+// count of its interpreter, of tasks not yet run.
+class WorkPool {
+public:
+    typedef std::function<void()> Task;
+    explicit WorkPool(size_t n);
+    WorkPool(const WorkPool &) = delete;
+    ~WorkPool();
+    size_t size() const { return queues.size(); }
+    void submit(Task t);
+    bool run_one();  // if any task is queued, as when waiting
+    void wait(const std::atomic<size_t> & left);  // helping until 0
+    static WorkPool & shared();  // of one worker per cpu
+    // note: sets the count of this thread, gives the prior
+    static std::atomic<size_t> * use_count(std::atomic<size_t> * c);
+    static void drain(const std::atomic<size_t> & c);  // until 0, if made
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Task> q;
+    };
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable more;  // tasks queued, or stop
+    std::condition_variable done;  // a task has run
+    std::atomic<size_t> queued;
+    std::atomic<size_t> busy;  // queued or running
+    size_t next;  // queue of a submit from outside
+    bool stop;
+    bool take(size_t i, Task & t);
+    void run(Task & t);
+    void work(size_t i);
+};
+
+} // ns
+
+#endif
@@ -0,0 +1,386 @@
+#include "profile.hpp"
+#include "compx.hpp"
+#include "except.hpp"
+#include <atomic>
+#include <memory>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <csignal>
+#include <sys/time.h>
+
+using namespace std;
+using namespace humble;
+
+namespace {
+
+// note: a sample is its depth followed by its frames, taken from a
+//       buffer made at start so that the handler does not allocate.
+constexpr size_t PROFILE_WORDS = 1 << 22;
+
+unique_ptr<uintptr_t[]> samples;
+atomic<size_t> used;
+atomic<size_t> dropped;
+string out_fn;
+Names * names;
+
+void on_prof(int)
+{
+    auto & s = profile_stack;
+    size_t n = s.n;
+    size_t k = min(n, PROFILE_DEPTH);
+    size_t at = used.fetch_add(k + 1, memory_order_relaxed);
+    if (at + k + 1 > PROFILE_WORDS) {
+        dropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    samples[at] = n;
+    for (size_t i = 0; i != k; ++i)
+        samples[at + 1 + i] = reinterpret_cast<uintptr_t>(s.f[i]);
+}
+
+string frame(LexEnv * e)
+{
+    string r = e->label ? names->get(e->label) : "lambda";
+    return r + ":" + to_string(e->line);
+}
+
+struct CountEntry {
+    long long calls;
+    long long self;  // ns
+    long long incl;
+    int active;  // calls in progress, of a recursion
+    bool host;
+};
+
+struct CountFrame {
+    long long start;
+    long long child;  // ns in calls made from it
+    CountEntry * e;
+};
+
+typedef unordered_map<uintptr_t, CountEntry> CountMap;
+
+mutex ended_mutex;
+CountMap ended;  // of threads that are done
+bool count_started;
+string count_fn;
+
+void merge(CountMap & m)
+{
+    lock_guard<mutex> g(ended_mutex);
+    for (auto & [k, e] : m) {
+        auto & r = ended[k];
+        r.calls += e.calls;
+        r.self += e.self;
+        r.incl += e.incl;
+        r.host = e.host;
+    }
+    m.clear();
+}
+
+// note: element references are kept in the frames, as these stay
+//       valid while an unordered_map grows.
+struct CountThread {
+    CountMap m;
+    vector<CountFrame> stack;
+    ~CountThread() { merge(m); }
+};
+
+thread_local CountThread counts;
+
+long long now_ns()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ll + t.tv_nsec;
+}
+
+// note: the names of a builtin are joined, as "eqv?/eq?"
+map<uintptr_t, string> host_names()
+{
+    map<uintptr_t, string> hosts;
+    auto & g = GlobalEnv::initial();
+    for (int k : g.keys())
+        if (auto e = g.get(k); e and holds_alternative<VarFunHost>(*e)) {
+            auto & s = hosts[reinterpret_cast<uintptr_t>(get<VarFunHost>(*e).p)];
+            s += (s.empty() ? "" : "/") + names->get(k);
+        }
+    return hosts;
+}
+
+struct TraceRec {
+    long long ns;
+    uintptr_t k;  // LexEnv or FunHost, or vars made for 'C'
+    unsigned tid;
+    char ph;  // 'B', 'E' or 'C', as in the json
+    bool host;
+};
+
+// note: a seqlock, the record being n + 1 when it is that of the
+//       nth call of trace_record, and 0 while written
+struct TraceSlot {
+    atomic<size_t> seq;
+    atomic<long long> ns;
+    atomic<uintptr_t> k;
+    atomic<unsigned> tid;
+    atomic<char> ph;
+    atomic<bool> host;
+};
+
+unique_ptr<TraceSlot[]> ring;
+atomic<size_t> ring_at;
+atomic<unsigned> trace_threads;
+string trace_fn;
+long long trace_t0;
+set<uintptr_t> io_hosts;
+
+thread_local unsigned trace_tid = ++trace_threads;
+thread_local long long alloc_mark;
+
+void trace_record(char ph, uintptr_t k, bool host)
+{
+    size_t n = ring_at.fetch_add(1, memory_order_relaxed);
+    auto & s = ring[n % TRACE_RECORDS];
+    s.seq.store(0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    s.ns.store(now_ns(), memory_order_relaxed);
+    s.k.store(k, memory_order_relaxed);
+    s.tid.store(trace_tid, memory_order_relaxed);
+    s.ph.store(ph, memory_order_relaxed);
+    s.host.store(host, memory_order_relaxed);
+    s.seq.store(n + 1, memory_order_release);
+}
+
+// note: false when the slot is not yet, or no longer, the nth
+bool trace_read(size_t n, TraceRec & r)
+{
+    auto & s = ring[n % TRACE_RECORDS];
+    if (s.seq.load(memory_order_acquire) != n + 1) return false;
+    r = {s.ns.load(memory_order_relaxed), s.k.load(memory_order_relaxed),
+        s.tid.load(memory_order_relaxed), s.ph.load(memory_order_relaxed),
+        s.host.load(memory_order_relaxed)};
+    atomic_thread_fence(memory_order_acquire);
+    return s.seq.load(memory_order_relaxed) == n + 1;
+}
+
+void on_usr1(int)
+{
+    trace_dump_pending = true;
+}
+
+string json_string(const string & s)
+{
+    string r = "\"";
+    for (char c : s) {
+        if (c == '"' or c == '\\') r += '\\';
+        r += c;
+    }
+    return r + "\"";
+}
+
+} // ans
+
+namespace humble {
+
+void count_enter(uintptr_t k, bool host)
+{
+    auto & c = counts;
+    auto & e = c.m[k];
+    e.host = host;
+    ++e.calls;
+    ++e.active;
+    c.stack.push_back({now_ns(), 0, &e});
+}
+
+void count_leave()
+{
+    auto & c = counts;
+    auto f = c.stack.back();
+    c.stack.pop_back();
+    long long d = now_ns() - f.start;
+    f.e->self += d - f.child;
+    if (--f.e->active == 0)
+        f.e->incl += d;
+    if (not c.stack.empty())
+        c.stack.back().child += d;
+}
+
+void count_start(const string & fn, Names & n)
+{
+    count_fn = fn;
+    names = &n;
+    count_started = true;
+    count_on = true;
+}
+
+void count_stop()
+{
+    if (not count_started) return;
+    count_started = false;
+    count_on = false;
+    merge(counts.m);
+    auto hosts = host_names();
+    vector<pair<string, CountEntry>> r;
+    for (auto & [k, e] : ended) {
+        string s = e.host ? hosts[k] : frame(reinterpret_cast<LexEnv *>(k));
+        r.emplace_back(s.empty() ? "?" : s, e);
+    }
+    sort(r.begin(), r.end(), [](auto & a, auto & b) {
+        return a.second.self > b.second.self;
+    });
+    ofstream f;
+    if (not count_fn.empty()) f.open(count_fn);
+    ostream & os = count_fn.empty() ? cerr : f;
+    os << setw(12) << "calls" << setw(12) << "self-ms"
+        << setw(12) << "incl-ms" << "  name\n";
+    for (auto & [s, e] : r)
+        os << setw(12) << e.calls << setw(12) << e.self / 1000000
+            << setw(12) << e.incl / 1000000 << "  " << s << "\n";
+}
+
+void trace_start(const string & fn, Names & n)
+{
+    ring.reset(new TraceSlot[TRACE_RECORDS]());
+    ring_at = 0;
+    trace_fn = fn;
+    names = &n;
+    trace_t0 = now_ns();
+    trace_on = true;
+    signal(SIGUSR1, on_usr1);
+}
+
+void trace_stop()
+{
+    if (not ring) return;
+    trace_on = false;
+    trace_dump("");
+    ring.reset();
+}
+
+void trace_io(FunHost p)
+{
+    io_hosts.insert(reinterpret_cast<uintptr_t>(p));
+}
+
+void trace_enter(uintptr_t k, bool host)
+{
+    if (trace_dump_pending.load(memory_order_relaxed)
+            and trace_dump_pending.exchange(false))
+        trace_dump("");
+    long long m = heap_counts.made[HEAP_VAR];
+    if (m - alloc_mark >= TRACE_ALLOC_STEP) {
+        alloc_mark = m;
+        trace_record('C', m, false);
+    }
+    trace_record('B', k, host);
+}
+
+void trace_leave()
+{
+    trace_record('E', 0, false);
+}
+
+// note: the oldest records are overwritten, so an 'E' of which the
+//       'B' is gone is left out, as is a record being written.  The counter is given as a rate,
+//       from the records of a thread.
+void trace_dump(const string & fn)
+{
+    if (not ring) return;
+    size_t end = ring_at.load();
+    size_t begin = end > TRACE_RECORDS ? end - TRACE_RECORDS : 0;
+    auto hosts = host_names();
+    map<unsigned, int> depth;
+    map<unsigned, TraceRec> last_counter;
+    ofstream os(fn.empty() ? trace_fn : fn);
+    os << "{\"traceEvents\":[";
+    const char * sep = "\n";
+    auto event = [&](const TraceRec & r) -> ostream & {
+        long long t = r.ns - trace_t0;
+        char ts[32];
+        snprintf(ts, sizeof ts, "%lld.%03lld", t / 1000, t % 1000);
+        os << sep << "{\"ph\":\"" << r.ph << "\",\"pid\":1,\"tid\":"
+            << r.tid << ",\"ts\":" << ts;
+        sep = ",\n";
+        return os;
+    };
+    for (size_t i = begin; i != end; ++i) {
+        TraceRec r;
+        if (not trace_read(i, r)) continue;
+        if (r.ph == 'E') {
+            if (depth[r.tid] == 0) continue;
+            --depth[r.tid];
+            event(r) << "}";
+        } else if (r.ph == 'B') {
+            ++depth[r.tid];
+            string name = r.host ? hosts[r.k]
+                : frame(reinterpret_cast<LexEnv *>(r.k));
+            const char * cat = not r.host ? "lambda"
+                : io_hosts.contains(r.k) ? "io" : "host";
+            event(r) << ",\"name\":" << json_string(name)
+                << ",\"cat\":\"" << cat << "\"}";
+        } else {
+            auto p = last_counter.find(r.tid);
+            if (p != last_counter.end() and r.ns > p->second.ns)
+                event(r) << ",\"name\":\"vars made\",\"args\":{\"per-ms\":"
+                    << (r.k - p->second.k) * 1000000 / (r.ns - p->second.ns)
+                    << "}}";
+            last_counter[r.tid] = r;
+        }
+    }
+    os << "\n]}\n";
+}
+
+void profile_start(const string & fn, Names & n, int hz)
+{
+    if (hz <= 0) throw CoreError("profile rate");
+    samples.reset(new uintptr_t[PROFILE_WORDS]);
+    out_fn = fn;
+    names = &n;
+    profile_on = true;
+    struct sigaction a{};
+    a.sa_handler = on_prof;
+    a.sa_flags = SA_RESTART;
+    sigemptyset(&a.sa_mask);
+    sigaction(SIGPROF, &a, nullptr);
+    itimerval t{};
+    t.it_interval.tv_usec = 1000000 / hz;
+    t.it_value = t.it_interval;
+    setitimer(ITIMER_PROF, &t, nullptr);
+}
+
+void profile_stop()
+{
+    if (not samples) return;
+    itimerval t{};
+    setitimer(ITIMER_PROF, &t, nullptr);
+    signal(SIGPROF, SIG_IGN);
+    map<string, long long> folded;
+    size_t end = min(used.load(), PROFILE_WORDS);
+    for (size_t at = 0; at < end; ) {
+        size_t n = samples[at];
+        size_t k = min(n, PROFILE_DEPTH);
+        if (at + k + 1 > end) break;
+        string line = "top";
+        for (size_t i = 0; i != k; ++i)
+            line += ";" + frame(reinterpret_cast<LexEnv *>(samples[at + 1 + i]));
+        if (n > k) line += ";...";
+        ++folded[line];
+        at += k + 1;
+    }
+    ofstream os(out_fn);
+    for (auto & [line, count] : folded)
+        os << line << " " << count << "\n";
+    if (dropped)
+        os << "top;(dropped) " << dropped << "\n";
+    samples.reset();
+}
+
+} // ns
@@ -0,0 +1,120 @@
+#ifndef HUMBLE_PROFILE
+#define HUMBLE_PROFILE
+
+#include "tok.hpp"
+#include "vars.hpp"
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+namespace humble {
+
+class LexEnv;
+
+// Sampling profiler of the lambdas run.  Each thread keeps a stack
+// of the lambdas that it is in (by their LexEnv), and a SIGPROF
+// timer copies the stack of the thread that it interrupts.  At
+// stop the samples are written as folded stacks, one line each of
+// frames "name:line" from the outermost, and the count.
+inline bool profile_on;
+constexpr size_t PROFILE_DEPTH = 64;  // outermost frames kept
+
+struct ProfileStack {
+    LexEnv * f[PROFILE_DEPTH];
+    size_t n;  // may be more than kept
+};
+inline thread_local ProfileStack profile_stack;
+
+void profile_start(const std::string & fn, Names & names, int hz);
+void profile_stop();  // and write, once
+
+// note: for the run of a lambda, with tail calls as replace
+struct ProfileScope {
+    bool on;
+    explicit ProfileScope(LexEnv * e) : on(profile_on)
+    {
+        if (not on) return;
+        auto & s = profile_stack;
+        if (s.n < PROFILE_DEPTH) s.f[s.n] = e;
+        std::atomic_signal_fence(std::memory_order_release);
+        ++s.n;
+    }
+    void replace(LexEnv * e)
+    {
+        if (not on) return;
+        auto & s = profile_stack;
+        if (s.n <= PROFILE_DEPTH) s.f[s.n - 1] = e;
+    }
+    ~ProfileScope() { if (on) --profile_stack.n; }
+};
+
+// Counting of the calls of lambdas and of builtins, with the time
+// spent in each (self) and under each (inclusive, where an outer
+// call of a recursion has the time of the inner ones).  At stop a
+// table is written, by self time.
+inline bool count_on;
+
+void count_start(const std::string & fn, Names & names);  // "" for stderr
+void count_stop();  // and write, once
+void count_enter(uintptr_t k, bool host);
+void count_leave();
+
+struct CountScope {
+    bool on;
+    explicit CountScope(LexEnv * e) : on(count_on)
+    {
+        if (on) count_enter(reinterpret_cast<uintptr_t>(e), false);
+    }
+    explicit CountScope(FunHost p) : on(count_on)
+    {
+        if (on) count_enter(reinterpret_cast<uintptr_t>(p), true);
+    }
+    void replace(LexEnv * e)
+    {
+        if (not on) return;
+        count_leave();
+        count_enter(reinterpret_cast<uintptr_t>(e), false);
+    }
+    ~CountScope() { if (on) count_leave(); }
+};
+
+// Tracing of the calls of lambdas and builtins into a ring of
+// records, kept with the time and thread and made into Chrome
+// trace-event json only when dumped: at stop, on SIGUSR1 (at the
+// next call) or by trace-dump.  A counter of the vars made is
+// recorded when a thread has made TRACE_ALLOC_STEP more, to show
+// allocation bursts, and builtins marked as io are so categorized.
+inline bool trace_on;
+inline std::atomic<bool> trace_dump_pending;
+constexpr size_t TRACE_RECORDS = 1 << 19;
+constexpr long long TRACE_ALLOC_STEP = 1024;
+
+void trace_start(const std::string & fn, Names & names);
+void trace_stop();  // and dump, once
+void trace_dump(const std::string & fn);  // "" for that of start
+void trace_io(FunHost p);
+void trace_enter(uintptr_t k, bool host);
+void trace_leave();
+
+struct TraceScope {
+    bool on;
+    explicit TraceScope(LexEnv * e) : on(trace_on)
+    {
+        if (on) trace_enter(reinterpret_cast<uintptr_t>(e), false);
+    }
+    explicit TraceScope(FunHost p) : on(trace_on)
+    {
+        if (on) trace_enter(reinterpret_cast<uintptr_t>(p), true);
+    }
+    void replace(LexEnv * e)
+    {
+        if (not on) return;
+        trace_leave();
+        trace_enter(reinterpret_cast<uintptr_t>(e), false);
+    }
+    ~TraceScope() { if (on) trace_leave(); }
+};
+
+} // ns
+
+#endif
@@ -0,0 +1,584 @@
+#include "regex.hpp"
+#include "except.hpp"
+#include <algorithm>
+
+using namespace std;
+using namespace humble;
+
+namespace {
+
+constexpr char32_t CODE_MAX = 0x10ffff;
+constexpr size_t NFA_STATES = 20000;
+constexpr int REPEAT_MAX = 1000;
+constexpr int NEST_MAX = 200;  // of groups, and of repeats of one atom
+
+typedef pair<char32_t, char32_t> Range;
+
+// note: lenient, as strings are checked where they are made,
+//       except from octal escapes.
+char32_t decode(string_view s, size_t & i)
+{
+    unsigned char u = s[i++];
+    if (u < 0x80) return u;
+    int k = u < 0xe0 ? 1 : u < 0xf0 ? 2 : 3;
+    char32_t c = u & (0x3f >> k);
+    for (; k and i < s.size(); --k)
+        c = c << 6 | (s[i++] & 0x3f);
+    return c;
+}
+
+// note: of the code point that ends at i, not before from
+char32_t decode_back(string_view s, size_t from, size_t & i)
+{
+    size_t j = i - 1;
+    while (j > from and i - j < 4 and (s[j] & 0xc0) == 0x80) --j;
+    i = j;
+    return decode(s, j);
+}
+
+vector<Range> normal(vector<Range> v)
+{
+    sort(v.begin(), v.end());
+    vector<Range> r;
+    for (auto & x : v) {
+        if (not r.empty() and x.first <= r.back().second + 1)
+            r.back().second = max(r.back().second, x.second);
+        else
+            r.push_back(x);
+    }
+    return r;
+}
+
+vector<Range> complement(const vector<Range> & v)
+{
+    vector<Range> r;
+    char32_t c = 0;
+    for (auto & x : normal(v)) {
+        if (c < x.first) r.push_back({c, x.first - 1});
+        c = x.second + 1;
+    }
+    if (c <= CODE_MAX) r.push_back({c, CODE_MAX});
+    return r;
+}
+
+bool in_set(const vector<Range> & v, char32_t c)
+{
+    for (auto & x : v) {
+        if (c < x.first) return false;
+        if (c <= x.second) return true;
+    }
+    return false;
+}
+
+// note: for \d \w \s and the negated, else empty
+vector<Range> class_escape(char32_t c)
+{
+    vector<Range> r;
+    switch (c) {
+        case 'd': case 'D':
+            r = {{'0', '9'}};
+            break;
+        case 'w': case 'W':
+            r = {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+            break;
+        case 's': case 'S':
+            r = {{'\t', '\r'}, {' ', ' '}};
+            break;
+        default:
+            return r;
+    }
+    if (c < 'a') r = complement(r);
+    return r;
+}
+
+char32_t char_escape(char32_t c)
+{
+    switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'v': return '\v';
+        case '0': return 0;
+    }
+    return c;
+}
+
+struct Node {
+    enum { SET, CAT, ALT, REP } kind;
+    vector<Range> set;
+    vector<Node> kids;
+    int min;
+    int max;  // or -1 for no bound
+};
+
+struct Frag {
+    int start;
+    vector<pair<int, int>> outs;  // of state, and if out1
+};
+
+} // ans
+
+namespace humble {
+
+struct RegexParse {
+    Regex & x;
+    string_view p;
+    size_t i;
+    int depth;  // of groups open
+
+    bool more() { return i < p.size(); }
+    char32_t peek() { size_t j = i; return decode(p, j); }
+    char32_t next() { return decode(p, i); }
+
+    Node alt()
+    {
+        Node r{Node::ALT, {}, {}, 0, 0};
+        r.kids.push_back(cat());
+        while (more() and peek() == '|') {
+            ++i;
+            r.kids.push_back(cat());
+        }
+        if (r.kids.size() == 1) return move(r.kids[0]);
+        return r;
+    }
+
+    Node cat()
+    {
+        Node r{Node::CAT, {}, {}, 0, 0};
+        while (more() and peek() != '|' and peek() != ')')
+            r.kids.push_back(repeat());
+        if (r.kids.size() == 1) return move(r.kids[0]);
+        return r;
+    }
+
+    bool number(int & n)
+    {
+        size_t j = i;
+        n = 0;
+        while (more() and '0' <= p[i] and p[i] <= '9') {
+            n = n * 10 + (p[i++] - '0');
+            if (n > REPEAT_MAX) throw RunError("regex repeat count");
+        }
+        return i != j;
+    }
+
+    // note: a '{' not making a count is taken as is
+    bool count(int & m, int & n)
+    {
+        size_t j = i++;
+        if (number(m)) {
+            n = m;
+            if (more() and p[i] == ',') {
+                ++i;
+                if (not number(n)) n = -1;
+            }
+            if (more() and p[i] == '}') {
+                ++i;
+                if (n >= 0 and n < m) throw RunError("regex repeat range");
+                return true;
+            }
+        }
+        i = j;
+        return false;
+    }
+
+    Node repeat()
+    {
+        Node a = atom();
+        for (int d = 0; more(); ++d) {
+            if (d == NEST_MAX) throw RunError("regex nested too deep");
+            int m, n;
+            char32_t c = peek();
+            if (c == '*') m = 0, n = -1;
+            else if (c == '+') m = 1, n = -1;
+            else if (c == '?') m = 0, n = 1;
+            else if (c == '{') {
+                if (not count(m, n)) break;
+                Node r{Node::REP, {}, {}, m, n};
+                r.kids.push_back(move(a));
+                a = move(r);
+                continue;
+            } else break;
+            ++i;
+            Node r{Node::REP, {}, {}, m, n};
+            r.kids.push_back(move(a));
+            a = move(r);
+        }
+        return a;
+    }
+
+    Node set(vector<Range> v)
+    {
+        return Node{Node::SET, normal(move(v)), {}, 0, 0};
+    }
+
+    Node atom()
+    {
+        char32_t c = next();
+        switch (c) {
+            case '(':
+                {
+                    if (p.substr(i, 2) == "?:") i += 2;
+                    if (++depth > NEST_MAX)
+                        throw RunError("regex nested too deep");
+                    Node r = alt();
+                    if (not more() or next() != ')')
+                        throw RunError("regex missing ')'");
+                    --depth;
+                    return r;
+                }
+            case '[':
+                return set(klass());
+            case '.':
+                return set(complement({{'\n', '\n'}}));
+            case '*': case '+': case '?':
+                throw RunError("regex repeat of nothing");
+            case '^': case '$':
+                throw RunError("regex ^ or $ inside");
+            case '\\':
+                {
+                    if (not more()) throw RunError("regex ends in '\\'");
+                    c = next();
+                    auto v = class_escape(c);
+                    if (not v.empty()) return set(move(v));
+                    c = char_escape(c);
+                }
+        }
+        return set({{c, c}});
+    }
+
+    char32_t class_char(vector<Range> & v)
+    {
+        char32_t c = next();
+        if (c != '\\') return c;
+        if (not more()) throw RunError("regex ends in '\\'");
+        c = next();
+        auto w = class_escape(c);
+        if (w.empty()) return char_escape(c);
+        v.insert(v.end(), w.begin(), w.end());
+        return CODE_MAX + 1;  // note: none, the set was added
+    }
+
+    vector<Range> klass()
+    {
+        vector<Range> v;
+        bool neg = more() and p[i] == '^';
+        if (neg) ++i;
+        bool first = true;
+        for (;;) {
+            if (not more()) throw RunError("regex missing ']'");
+            if (p[i] == ']' and not first) break;
+            first = false;
+            char32_t a = class_char(v);
+            if (a > CODE_MAX) continue;
+            char32_t b = a;
+            if (p.substr(i, 1) == "-" and p.substr(i + 1, 1) != "]"
+                    and i + 1 < p.size()) {
+                ++i;
+                b = class_char(v);
+                if (b > CODE_MAX or b < a)
+                    throw RunError("regex class range");
+            }
+            v.push_back({a, b});
+        }
+        ++i;
+        return neg ? complement(v) : v;
+    }
+
+    int add(int kind, int set = -1)
+    {
+        if (x.nfa.size() == NFA_STATES) throw RunError("regex too large");
+        x.nfa.push_back({kind, set, -1, -1});
+        return x.nfa.size() - 1;
+    }
+
+    void patch(const vector<pair<int, int>> & outs, int to)
+    {
+        for (auto & [s, w] : outs)
+            (w ? x.nfa[s].out1 : x.nfa[s].out) = to;
+    }
+
+    Frag compile(const Node & a)
+    {
+        switch (a.kind) {
+            case Node::SET:
+                {
+                    x.sets.push_back(a.set);
+                    int s = add(Regex::N_SET, x.sets.size() - 1);
+                    return {s, {{s, 0}}};
+                }
+            case Node::CAT:
+                {
+                    if (a.kids.empty()) {
+                        int s = add(Regex::N_JUMP);
+                        return {s, {{s, 0}}};
+                    }
+                    Frag r = compile(a.kids[0]);
+                    for (size_t k = 1; k != a.kids.size(); ++k) {
+                        Frag f = compile(a.kids[k]);
+                        patch(r.outs, f.start);
+                        r.outs = move(f.outs);
+                    }
+                    return r;
+                }
+            case Node::ALT:
+                {
+                    vector<Frag> w;
+                    for (auto & k : a.kids) w.push_back(compile(k));
+                    Frag r = move(w.back());
+                    for (size_t k = w.size() - 1; k--; ) {
+                        int s = add(Regex::N_SPLIT);
+                        x.nfa[s].out = w[k].start;
+                        x.nfa[s].out1 = r.start;
+                        r.start = s;
+                        r.outs.insert(r.outs.end(),
+                                w[k].outs.begin(), w[k].outs.end());
+                    }
+                    return r;
+                }
+            case Node::REP:
+                break;
+        }
+        // note: the kid is compiled once per copy in the expansion
+        //       of x{m,n} into m of x and then n - m optional x.
+        Node empty{Node::CAT, {}, {}, 0, 0};
+        Frag r = compile(empty);
+        for (int k = 0; k != a.min; ++k) {
+            Frag f = compile(a.kids[0]);
+            patch(r.outs, f.start);
+            r.outs = move(f.outs);
+        }
+        if (a.max < 0) {
+            int s = add(Regex::N_SPLIT);
+            Frag f = compile(a.kids[0]);
+            x.nfa[s].out = f.start;
+            patch(f.outs, s);
+            patch(r.outs, s);
+            r.outs = {{s, 1}};
+            return r;
+        }
+        for (int k = a.min; k != a.max; ++k) {
+            int s = add(Regex::N_SPLIT);
+            Frag f = compile(a.kids[0]);
+            x.nfa[s].out = f.start;
+            patch(r.outs, s);
+            r.outs = move(f.outs);
+            r.outs.push_back({s, 1});
+        }
+        return r;
+    }
+};
+
+Regex::Regex(string_view pattern)
+    : start()
+    , at_begin()
+    , at_end()
+    , accept()
+    , anchored{false, false, {}, {}, 0, -1}
+    , floating{true, false, {}, {}, 0, -1}
+    , backward{true, true, {}, {}, 0, -1}
+{
+    if (pattern.starts_with('^')) {
+        at_begin = true;
+        pattern.remove_prefix(1);
+    }
+    if (pattern.ends_with('$')) {
+        size_t k = 0;  // of '\\' before
+        while (k + 1 < pattern.size()
+                and pattern[pattern.size() - 2 - k] == '\\') ++k;
+        if (k % 2 == 0) {
+            at_end = true;
+            pattern.remove_suffix(1);
+        }
+    }
+    RegexParse r{*this, pattern, 0, 0};
+    Node a = r.alt();
+    if (r.more()) throw RunError("regex unmatched ')'");
+    Frag f = r.compile(a);
+    int m = r.add(N_MATCH);
+    r.patch(f.outs, m);
+    start = f.start;
+    accept = m;
+    backward.floating = not at_end;
+    into.resize(nfa.size());
+    for (int i = 0; i != int(nfa.size()); ++i) {
+        auto & s = nfa[i];
+        if (s.kind == N_MATCH) continue;
+        if (s.out >= 0) into[s.out].push_back(i);
+        if (s.kind == N_SPLIT and s.out1 >= 0) into[s.out1].push_back(i);
+    }
+}
+
+void Regex::closure(int i, vector<int> & r, vector<bool> & seen)
+{
+    while (i >= 0 and not seen[i]) {
+        seen[i] = true;
+        auto & s = nfa[i];
+        if (s.kind == N_SET or s.kind == N_MATCH) {
+            r.push_back(i);
+            return;
+        }
+        if (s.kind == N_SPLIT) closure(s.out1, r, seen);
+        i = s.out;
+    }
+}
+
+// note: back from i over empty edges to the N_SET states before,
+//       with -1 for the start, which is where a reversed match is.
+void Regex::rclosure(int i, vector<int> & r, vector<bool> & seen)
+{
+    vector<int> todo{i};
+    while (not todo.empty()) {
+        int j = todo.back();
+        todo.pop_back();
+        if (seen[j]) continue;
+        seen[j] = true;
+        if (j == start) r.push_back(-1);
+        for (int p : into[j]) {
+            if (nfa[p].kind != N_SET)
+                todo.push_back(p);
+            else
+                r.push_back(p);
+        }
+    }
+}
+
+int Regex::intern(Dfa & d, vector<int> && n)
+{
+    sort(n.begin(), n.end());
+    n.erase(unique(n.begin(), n.end()), n.end());
+    if (auto it = d.ids.find(n); it != d.ids.end())
+        return it->second;
+    if (d.states.size() == DFA_STATES) {
+        d.states.clear();
+        d.ids.clear();
+        d.init = -1;
+        ++d.epoch;
+    }
+    bool match = d.backward ? not n.empty() and n.front() < 0
+        : any_of(n.begin(), n.end(),
+            [this](int i) { return nfa[i].kind == N_MATCH; });
+    int k = d.states.size();
+    d.ids[n] = k;
+    d.states.push_back({move(n), match, {}, {}});
+    d.states.back().ascii.fill(-1);
+    return k;
+}
+
+int Regex::initial(Dfa & d)
+{
+    if (d.init < 0) {
+        vector<int> r;
+        vector<bool> seen(nfa.size());
+        if (d.backward) rclosure(accept, r, seen);
+        else closure(start, r, seen);
+        d.init = intern(d, move(r));
+    }
+    return d.init;
+}
+
+int Regex::step(Dfa & d, int k, char32_t c)
+{
+    {
+        auto & x = d.states[k];
+        if (c < 128) {
+            if (x.ascii[c] >= 0) return x.ascii[c];
+        } else if (auto it = x.other.find(c); it != x.other.end()) {
+            return it->second;
+        }
+    }
+    vector<int> r;
+    vector<bool> seen(nfa.size());
+    if (d.backward) {
+        for (int i : d.states[k].n)
+            if (i >= 0 and in_set(sets[nfa[i].set], c))
+                rclosure(i, r, seen);
+        if (d.floating) rclosure(accept, r, seen);
+    } else {
+        for (int i : d.states[k].n)
+            if (nfa[i].kind == N_SET and in_set(sets[nfa[i].set], c))
+                closure(nfa[i].out, r, seen);
+        if (d.floating) closure(start, r, seen);
+    }
+    auto e = d.epoch;
+    int t = intern(d, move(r));
+    if (e == d.epoch) {
+        auto & x = d.states[k];
+        if (c < 128) x.ascii[c] = t;
+        else x.other[c] = t;
+    }
+    return t;
+}
+
+size_t Regex::longest(string_view s, size_t i)
+{
+    int k = initial(anchored);
+    size_t r = anchored.states[k].match ? i : s.npos;
+    while (i < s.size()) {
+        k = step(anchored, k, decode(s, i));
+        auto & x = anchored.states[k];
+        if (x.n.empty()) break;
+        if (x.match) r = i;
+    }
+    return r;
+}
+
+// note: the floating pass finds where the first match ends, or that
+//       there is none, in one go.  the matches that start by then
+//       end by where the pass ends when it takes no new start, and
+//       the leftmost start is found going back from there with the
+//       regex reversed.  so each pass is linear in the string.
+bool Regex::search(string_view s, size_t from, pair<size_t, size_t> & m)
+{
+    if (from > s.size() or (at_begin and from != 0))
+        return false;
+    if (at_begin) {
+        size_t r = longest(s, from);
+        if (r == s.npos or (at_end and r != s.size()))
+            return false;
+        m = {from, r};
+        return true;
+    }
+    size_t e = s.npos;
+    size_t i = from;
+    int k = initial(floating);
+    if (floating.states[k].match and (not at_end or i == s.size()))
+        e = i;
+    while (e == s.npos and i < s.size()) {
+        k = step(floating, k, decode(s, i));
+        if (floating.states[k].match and (not at_end or i == s.size()))
+            e = i;
+    }
+    if (e == s.npos) return false;
+    size_t l = e;
+    if (not at_end) {
+        int j = intern(anchored, vector<int>(floating.states[k].n));
+        while (i < s.size()) {
+            j = step(anchored, j, decode(s, i));
+            auto & x = anchored.states[j];
+            if (x.n.empty()) break;
+            if (x.match) l = i;
+        }
+    }
+    size_t b = s.npos;
+    i = l;
+    k = initial(backward);
+    if (backward.states[k].match) b = i;
+    while (i > from) {
+        k = step(backward, k, decode_back(s, from, i));
+        auto & x = backward.states[k];
+        if (x.match) b = i;
+        if (x.n.empty() and not backward.floating) break;
+    }
+    if (b == s.npos) return false;  // note: not so, as e is a match end
+    m = {b, at_end ? s.size() : longest(s, b)};
+    return true;
+}
+
+bool Regex::match(string_view s)
+{
+    return longest(s, 0) == s.size();
+}
+
+} // ns
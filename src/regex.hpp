@@ -0,0 +1,76 @@
+#ifndef HUMBLE_REGEX
+#define HUMBLE_REGEX
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace humble {
+
+// Regular expression over code points, compiled to a Thompson
+// NFA that is walked as a DFA made lazily (a state per set of
+// NFA states, as they are reached).  There is no backtracking,
+// and a search is linear in the string: forward to the end of
+// the first match, then back with the NFA reversed to its start.
+// Syntax: . [] [^] \d \w \s (and negated) * + ? {m,n} | (?:)
+// with ^ and $ only at the ends of the pattern.  A match is
+// leftmost-longest and groups do not capture.
+class Regex {
+public:
+    explicit Regex(std::string_view pattern);
+    // byte offsets of the match found starting at from or after
+    bool search(std::string_view s, size_t from,
+            std::pair<size_t, size_t> & m);
+    bool match(std::string_view s);  // whole string
+    // note: the cache is dropped when it grows past this
+    static constexpr size_t DFA_STATES = 1024;
+private:
+    typedef std::pair<char32_t, char32_t> Range;
+    enum { N_SET, N_JUMP, N_SPLIT, N_MATCH };
+    struct NState {
+        int kind;
+        int set;
+        int out;
+        int out1;
+    };
+    struct DState {
+        std::vector<int> n;  // of N_SET and N_MATCH states, or -1
+        // (the start) and N_SET states when backward
+        bool match;
+        std::array<int, 128> ascii;
+        std::unordered_map<char32_t, int> other;
+    };
+    struct Dfa {
+        bool floating;  // when the start is added at each step
+        bool backward;  // on the NFA reversed, from the match state
+        std::vector<DState> states;
+        std::map<std::vector<int>, int> ids;
+        size_t epoch;  // of times dropped
+        int init;
+    };
+    std::vector<std::vector<Range>> sets;
+    std::vector<NState> nfa;
+    int start;
+    bool at_begin;
+    bool at_end;
+    int accept;  // the N_MATCH state
+    std::vector<std::vector<int>> into;  // by state, those to it
+    Dfa anchored;
+    Dfa floating;
+    Dfa backward;
+    friend struct RegexParse;
+    void closure(int i, std::vector<int> & r, std::vector<bool> & seen);
+    void rclosure(int i, std::vector<int> & r, std::vector<bool> & seen);
+    int intern(Dfa & d, std::vector<int> && n);
+    int step(Dfa & d, int k, char32_t c);
+    int initial(Dfa & d);
+    size_t longest(std::string_view s, size_t i);
+};
+
+} // ns
+
+#endif
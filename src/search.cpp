@@ -0,0 +1,122 @@
+#include "search.hpp"
+#include "except.hpp"
+#include <cstring>
+#include <deque>
+
+using namespace std;
+using namespace humble;
+
+namespace humble {
+
+OnePattern::OnePattern(string needle)
+    : u(move(needle))
+{
+    size_t m = u.size();
+    shift.fill(m ? m : 1);
+    for (size_t i = 0; i + 1 < m; ++i)
+        shift[static_cast<unsigned char>(u[i])] = m - 1 - i;
+}
+
+// note: memchr (vectorized in the c library) skips to where the
+//       first byte is, and a mismatch then moves the window by the
+//       shift of its last byte before looking for the next.
+bool OnePattern::find(string_view s, size_t from, SearchMatch & m) const
+{
+    size_t n = u.size();
+    if (from > s.size() or s.size() - from < n)
+        return false;
+    if (n == 0) {
+        m = {from, 0, 0};
+        return true;
+    }
+    const char * p = s.data();
+    size_t end = s.size() - n;  // last window start
+    size_t j = from;
+    while (j <= end) {
+        auto q = static_cast<const char *>(memchr(p + j, u[0], end - j + 1));
+        if (not q) return false;
+        j = q - p;
+        if (memcmp(q + 1, u.data() + 1, n - 1) == 0) {
+            m = {j, n, 0};
+            return true;
+        }
+        j += shift[static_cast<unsigned char>(p[j + n - 1])];
+    }
+    return false;
+}
+
+ManyPattern::ManyPattern(const vector<string> & needles)
+    : longest()
+{
+    array<int, 256> none;
+    none.fill(-1);
+    next.push_back(none);
+    out.emplace_back();
+    for (size_t k = 0; k != needles.size(); ++k) {
+        auto & w = needles[k];
+        if (w.empty()) throw RunError("pattern empty needle");
+        int t = 0;
+        for (unsigned char c : w) {
+            if (next[t][c] < 0) {
+                next[t][c] = next.size();
+                next.push_back(none);
+                out.emplace_back();
+            }
+            t = next[t][c];
+        }
+        out[t].push_back(k);
+        sizes.push_back(w.size());
+        longest = max(longest, w.size());
+    }
+    // note: breadth first, so that the fail state of a state is
+    //       done before it, and holes become the fail transitions.
+    vector<int> fail(next.size());
+    deque<int> q;
+    for (auto & t : next[0]) {
+        if (t < 0) t = 0;
+        else q.push_back(t);
+    }
+    while (not q.empty()) {
+        int t = q.front();
+        q.pop_front();
+        auto & f = out[fail[t]];
+        out[t].insert(out[t].end(), f.begin(), f.end());
+        for (int c = 0; c != 256; ++c) {
+            int & x = next[t][c];
+            if (x < 0) {
+                x = next[fail[t]][c];
+            } else {
+                fail[x] = next[fail[t]][c];
+                q.push_back(x);
+            }
+        }
+    }
+}
+
+bool ManyPattern::find(string_view s, size_t from, SearchMatch & m) const
+{
+    bool found = false;
+    int t = 0;
+    for (size_t i = from; i < s.size(); ++i) {
+        // note: no later match can start before the one found
+        if (found and i >= m.at + longest) break;
+        t = next[t][static_cast<unsigned char>(s[i])];
+        for (auto k : out[t]) {
+            size_t a = i + 1 - sizes[k];
+            if (not found or a < m.at or (a == m.at and sizes[k] > m.n)) {
+                m = {a, sizes[k], k};
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+unique_ptr<Pattern> make_pattern(vector<string> needles)
+{
+    if (needles.size() == 1)
+        return make_unique<OnePattern>(move(needles[0]));
+    return make_unique<ManyPattern>(needles);
+}
+
+} // ns
@@ -0,0 +1,56 @@
+#ifndef HUMBLE_SEARCH
+#define HUMBLE_SEARCH
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+
+namespace humble {
+
+struct SearchMatch {
+    size_t at;  // byte offset
+    size_t n;   // of bytes matched
+    size_t k;   // which needle
+};
+
+// Compiled needle(s) to search for in many strings.  A match is
+// the leftmost one, and of the needles matching there the longest.
+class Pattern {
+public:
+    virtual ~Pattern() = default;
+    virtual bool find(std::string_view s, size_t from,
+            SearchMatch & m) const = 0;
+};
+
+// Horspool over candidates given by memchr of the first byte.
+class OnePattern : public Pattern {
+public:
+    explicit OnePattern(std::string needle);
+    bool find(std::string_view s, size_t from,
+            SearchMatch & m) const override;
+private:
+    std::string u;
+    std::array<size_t, 256> shift;
+};
+
+// Aho-Corasick, with the transitions made full, so one lookup
+// per byte.
+class ManyPattern : public Pattern {
+public:
+    explicit ManyPattern(const std::vector<std::string> & needles);
+    bool find(std::string_view s, size_t from,
+            SearchMatch & m) const override;
+private:
+    std::vector<std::array<int, 256>> next;
+    std::vector<std::vector<size_t>> out;  // needles ending at state
+    std::vector<size_t> sizes;
+    size_t longest;
+};
+
+std::unique_ptr<Pattern> make_pattern(std::vector<std::string> needles);
+
+} // ns
+
+#endif
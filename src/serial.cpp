@@ -0,0 +1,327 @@
+#include "serial.hpp"
+#include "cons.hpp"
+#include "except.hpp"
+#include "utf.hpp"
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace humble;
+
+namespace {
+
+enum : unsigned char {
+    S_VOID, S_FALSE, S_TRUE, S_NUM, S_NAME,
+    S_STRING, S_LIST, S_NONLIST, S_REC, S_CONS, S_REF,
+};
+
+// note: how a cons chain ends, after its cars
+enum : unsigned char { T_END, T_CELL, T_VALUE };
+
+constexpr size_t RESERVE_MAX = 1 << 16;  // as the count is not trusted
+
+// note: a cons cell, at 0, or a place in a list store without cells
+struct Place {
+    const void * p;
+    size_t i;
+    bool operator==(const Place &) const = default;
+};
+
+struct PlaceHash {
+    size_t operator()(const Place & x) const
+    {
+        return hash<const void *>()(x.p) ^ x.i * 0x9e3779b97f4a7c15;
+    }
+};
+
+struct SerialWriter {
+    Names & names;
+    string & out;
+    unordered_map<const Var *, size_t> vars;
+    unordered_map<Place, size_t, PlaceHash> cells;
+    int depth;
+
+    void num(unsigned long long u)
+    {
+        while (u >= 0x80) {
+            out.push_back(static_cast<char>(u bitor 0x80));
+            u >>= 7;
+        }
+        out.push_back(static_cast<char>(u));
+    }
+
+    void bytes(const string & s)
+    {
+        num(s.size());
+        out += s;
+    }
+
+    void elements(unsigned char t, const vector<EnvEntry> & v)
+    {
+        out.push_back(t);
+        num(v.size());
+        for (auto & x : v) write(x);
+    }
+
+    // note: the cells of the chain are numbered before any car is
+    //       written, so that the reader makes them all first too.
+    void cons(const Cons * p)
+    {
+        out.push_back(S_CONS);
+        vector<const Cons *> v;
+        while (p and not cells.contains({p, 0})) {
+            cells.emplace(Place{p, 0}, cells.size());
+            v.push_back(p);
+            if (not holds_alternative<ConsPtr>(p->d)) break;
+            p = get<ConsPtr>(p->d).get();
+        }
+        num(v.size());
+        for (auto q : v) write(q->a);
+        if (not v.empty() and holds_alternative<EnvEntry>(v.back()->d)) {
+            out.push_back(T_VALUE);
+            write(get<EnvEntry>(v.back()->d));
+        } else if (p) {
+            out.push_back(T_CELL);
+            num(cells[{p, 0}]);
+        } else {
+            out.push_back(T_END);
+        }
+    }
+
+    // note: as the cells the store would make, from i on, numbered
+    //       by place, so that the store is left as it is
+    void view(const ListStore & s, size_t i)
+    {
+        out.push_back(S_CONS);
+        size_t j = i;
+        while (j != s.size() and not cells.contains({&s, j}))
+            cells.emplace(Place{&s, j++}, cells.size());
+        num(j - i);
+        for (size_t k = i; k != j; ++k) write(s.v[k]);
+        if (j != s.size()) {
+            out.push_back(T_CELL);
+            num(cells[{&s, j}]);
+        } else if (s.dot) {
+            out.push_back(T_VALUE);
+            write(s.v.back());
+        } else {
+            out.push_back(T_END);
+        }
+    }
+
+    void write(const EnvEntry & e)
+    {
+        if (depth == SERIAL_DEPTH) throw RunError("serialize too deep");
+        ++depth;
+        value(*e);
+        --depth;
+    }
+
+    void value(const Var & x)
+    {
+        if (auto it = vars.find(&x); it != vars.end()) {
+            out.push_back(S_REF);
+            num(it->second);
+            return;
+        }
+        vars.emplace(&x, vars.size());
+        if (holds_alternative<VarVoid>(x)) {
+            out.push_back(S_VOID);
+        } else if (holds_alternative<VarBool>(x)) {
+            out.push_back(get<VarBool>(x).b ? S_TRUE : S_FALSE);
+        } else if (holds_alternative<VarNum>(x)) {
+            long long i = get<VarNum>(x).i;
+            out.push_back(S_NUM);
+            num((static_cast<unsigned long long>(i) << 1) ^ (i >> 63));
+        } else if (holds_alternative<VarNam>(x)) {
+            out.push_back(S_NAME);
+            bytes(names.get(get<VarNam>(x).h));
+        } else if (holds_alternative<VarString>(x)) {
+            out.push_back(S_STRING);
+            bytes(get<VarString>(x).s);
+        } else if (holds_alternative<VarList>(x)) {
+            elements(S_LIST, get<VarList>(x).v);
+        } else if (holds_alternative<VarNonlist>(x)) {
+            elements(S_NONLIST, get<VarNonlist>(x).v);
+        } else if (holds_alternative<VarRec>(x)) {
+            elements(S_REC, get<VarRec>(x).v);
+        } else if (holds_alternative<VarCons>(x)) {
+            cons(get<VarCons>(x).c.get());
+        } else if (holds_alternative<VarView>(x)) {
+            auto & w = get<VarView>(x);
+            if (w.s->cells.empty()) view(*w.s, w.i);
+            else cons(w.s->cells[w.i].get());
+        } else {
+            throw RunError(string("serialize of ") + var_type_name(x));
+        }
+    }
+};
+
+struct SerialReader {
+    function<int()> & get;
+    Names & names;
+    vector<EnvEntry> vars;
+    vector<ConsPtr> cells;
+    int depth;
+
+    unsigned char byte()
+    {
+        int k = get();
+        if (k < 0) throw RunError("deserialize input ends");
+        return k;
+    }
+
+    unsigned long long num()
+    {
+        unsigned long long r{};
+        for (int s = 0;; s += 7) {
+            if (s > 63) throw RunError("deserialize varint");
+            unsigned char k = byte();
+            r |= static_cast<unsigned long long>(k bitand 0x7f) << s;
+            if (k < 0x80) return r;
+        }
+    }
+
+    string bytes()
+    {
+        auto n = num();
+        string r;
+        r.reserve(min<size_t>(n, RESERVE_MAX));
+        while (n--) r.push_back(byte());
+        return r;
+    }
+
+    template <typename T>
+    EnvEntry elements(size_t least)
+    {
+        auto r = make_var(T{});
+        vars.push_back(r);
+        auto n = num();
+        if (n < least) throw RunError("deserialize short");
+        vector<EnvEntry> v;
+        v.reserve(min<size_t>(n, RESERVE_MAX));
+        while (n--) v.push_back(read());
+        std::get<T>(*r).v = move(v);
+        return r;
+    }
+
+    ConsPtr cell(unsigned long long i)
+    {
+        if (i >= cells.size()) throw RunError("deserialize cell");
+        return cells[i];
+    }
+
+    EnvEntry cons()
+    {
+        auto r = make_var(VarCons{});
+        vars.push_back(r);
+        auto n = num();
+        size_t k = cells.size();
+        for (auto j = n; j--; ) {
+            cells.push_back(make_cons(nullptr, ConsPtr{}));
+            if (cells.size() - k > 1)
+                cells[cells.size() - 2]->d = cells.back();
+        }
+        for (size_t j = k; j != k + n; ++j)
+            cells[j]->a = read();
+        ConsPtr c = n ? cells[k] : nullptr;
+        switch (byte()) {
+            case T_END:
+                break;
+            case T_CELL:
+                if (n) cells.back()->d = cell(num());
+                else c = cell(num());
+                break;
+            case T_VALUE:
+                if (n < 1) throw RunError("deserialize cons tail");
+                cells.back()->d = read();
+                break;
+            default:
+                throw RunError("deserialize cons end");
+        }
+        std::get<VarCons>(*r).c = c;
+        return r;
+    }
+
+    EnvEntry noted(EnvEntry r)
+    {
+        vars.push_back(r);
+        return r;
+    }
+
+    EnvEntry read()
+    {
+        if (depth == SERIAL_DEPTH) throw RunError("deserialize too deep");
+        ++depth;
+        auto r = value();
+        --depth;
+        return r;
+    }
+
+    EnvEntry value()
+    {
+        switch (byte()) {
+            case S_VOID:
+                return noted(make_var(VarVoid{}));
+            case S_FALSE:
+                return noted(make_var(VarBool{false}));
+            case S_TRUE:
+                return noted(make_var(VarBool{true}));
+            case S_NUM:
+                {
+                    auto u = num();
+                    long long i = (u >> 1) ^ -static_cast<long long>(u & 1);
+                    return noted(make_var(VarNum{i}));
+                }
+            case S_NAME:
+                return noted(make_var(VarNam{names.intern(bytes())}));
+            case S_STRING:
+                {
+                    auto r = make_var(VarString{});
+                    vars.push_back(r);
+                    auto & x = std::get<VarString>(*r).s;
+                    x = bytes();
+                    if (not utf_valid(x))
+                        throw RunError("deserialize not utf8");
+                    return r;
+                }
+            case S_LIST:
+                return elements<VarList>(1);  // note: as never empty
+            case S_NONLIST:
+                return elements<VarNonlist>(2);
+            case S_REC:
+                return elements<VarRec>(1);
+            case S_CONS:
+                return cons();
+            case S_REF:
+                {
+                    auto i = num();
+                    if (i >= vars.size()) throw RunError("deserialize ref");
+                    return vars[i];
+                }
+        }
+        throw RunError("deserialize tag");
+    }
+};
+
+} // ans
+
+namespace humble {
+
+void serial_write(EnvEntry x, Names & names, string & out)
+{
+    out.push_back(SERIAL_VERSION);
+    SerialWriter w{names, out, {}, {}, 0};
+    w.write(x);
+}
+
+EnvEntry serial_read(function<int()> get, Names & names)
+{
+    int k = get();
+    if (k < 0) return nullptr;
+    if (k != SERIAL_VERSION) throw RunError("deserialize version");
+    SerialReader r{get, names, {}, {}, 0};
+    return r.read();
+}
+
+} // ns
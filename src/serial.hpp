@@ -0,0 +1,27 @@
+#ifndef HUMBLE_SERIAL
+#define HUMBLE_SERIAL
+
+#include "vars.hpp"
+#include "tok.hpp"
+#include <string>
+#include <functional>
+
+namespace humble {
+
+// Binary form of a variable, as a tag byte and then what the tag
+// tells, with numbers as (zigzag) varints and names by spelling.
+// A var met again, of any type, is written as a reference to the
+// first, and so are cons cells, so that sharing, aliases and cycles
+// are kept.  A view of a list is written as the cons cells it stands
+// for, and read as those, without making them in the list written.
+// Functions and ext vars are not written, and nesting deeper than
+// SERIAL_DEPTH raises RunError either way.
+constexpr unsigned char SERIAL_VERSION = 2;
+constexpr int SERIAL_DEPTH = 2000;
+void serial_write(EnvEntry x, Names & names, std::string & out);
+// note: null when the input ends before the version byte
+EnvEntry serial_read(std::function<int()> get, Names & names);
+
+} // ns
+
+#endif
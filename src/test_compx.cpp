@@ -1,7 +1,10 @@
 #include "compx.hpp"
+#include "cons.hpp"
 #include "debug.hpp"
 #include "except.hpp"
 #include "gtest/gtest.h"
+#include <climits>
+#include <sstream>
 
 using namespace humble;
 using namespace std;
@@ -53,3 +56,95 @@ TEST(compx, unbound)
     compx_dispose(local_envs);
 }
 
+
+TEST(compx, lambda_label)
+{
+    vector<LexEnv *> local_envs;
+    vector<Lex> t{LexForm{{LexOp{OP_BIND}, LexNam{7, 2},
+        LexForm{{LexOp{OP_LAMBDA}, LexArgs{}, LexArgs{}, LexNum{1},
+            LexNam{8, 3}}}}}};
+    zloc_scopes(t, nullptr, local_envs);
+    ASSERT_EQ(1, local_envs.size());
+    ASSERT_EQ(7, local_envs[0]->label);
+    ASSERT_EQ(3, local_envs[0]->line);
+    vector<Lex> u{LexForm{{
+        LexForm{{LexOp{OP_LAMBDA}, LexArgs{-5}, LexArgs{}, LexNum{1}}},
+        LexForm{{LexOp{OP_LAMBDA}, LexArgs{}, LexArgs{}, LexNum{1}}}}}};
+    zloc_scopes(u, nullptr, local_envs);
+    ASSERT_EQ(3, local_envs.size());
+    ASSERT_EQ(0, local_envs[1]->label);
+    ASSERT_EQ(5, local_envs[2]->label);
+    compx_dispose(local_envs);
+}
+
+namespace {
+
+EnvEntry num(long long i) { return make_var(VarNum{i}); }
+
+string printed(EnvEntry a, Names & n)
+{
+    string r;
+    Printer p(n, r);
+    p.print(a);
+    return r;
+}
+
+} // ans
+
+TEST(Printer, atoms)
+{
+    Names n = init_names();
+    auto h = n.intern("foo");
+    ASSERT_EQ("-9223372036854775808", printed(num(LLONG_MIN), n));
+    ASSERT_EQ("0", printed(num(0), n));
+    ASSERT_EQ("\"say \\\"hi\\\"\"", printed(make_var(VarString{"say \"hi\""}), n));
+    ASSERT_EQ("#t", printed(make_var(VarBool{true}), n));
+    ASSERT_EQ("#void", printed(make_var(VarVoid{}), n));
+    ASSERT_EQ("foo", printed(make_var(VarNam{h}), n));
+    ASSERT_EQ("()", printed(make_var(VarCons{}), n));
+}
+
+TEST(Printer, lists)
+{
+    Names n = init_names();
+    auto x = make_var(VarList{{ num(1), make_var(VarList{{ num(2) }}), num(3) }});
+    ASSERT_EQ("(1 (2) 3)", printed(x, n));
+    ASSERT_EQ("(1 2 . 3)",
+            printed(make_var(VarNonlist{{ num(1), num(2), num(3) }}), n));
+    ASSERT_EQ("#r(1 2)", printed(make_var(VarRec{{ num(1), num(2) }}), n));
+    auto c = make_cons(num(1), make_cons(num(2), num(3)));
+    ASSERT_EQ("(1 2 . 3)", printed(make_var(VarCons{c}), n));
+    auto y = list_cdr(*x);
+    ASSERT_EQ("((2) 3)", printed(y, n));
+    ASSERT_TRUE(holds_alternative<VarView>(*x));
+    ASSERT_EQ("(1 (2) 3)", printed(x, n));
+    unview(*x);  // note: the tail is then a view of the cells
+    ASSERT_EQ("(1 (2) 3)", printed(x, n));
+    ASSERT_EQ("((2) 3)", printed(y, n));
+}
+
+TEST(Printer, stream)
+{
+    Names n = init_names();
+    vector<EnvEntry> v;
+    for (int i = 0; i != 20000; ++i) v.push_back(num(i));
+    auto x = make_var(VarList{move(v)});
+    auto s = printed(x, n);
+    ASSERT_GT(s.size(), Printer::FLUSH_SIZE);
+    ostringstream os;
+    {
+        Printer p(n, os);
+        p.put("[");
+        {
+            ostringstream inner;  // note: while the thread buffer is used
+            print(num(7), n, inner);
+            ASSERT_EQ("7", inner.str());
+        }
+        p.print(x);
+        p.put("]");
+    }
+    ASSERT_EQ("[" + s + "]", os.str());
+    ostringstream again;
+    print(x, n, again);
+    ASSERT_EQ(s, again.str());
+}
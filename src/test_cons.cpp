@@ -74,3 +74,58 @@ TEST_F(ConsTest, ConsOrListIter)
     auto j = make_iter(c);
     ASSERT_EQ(s, j->get());
 }
+
+TEST_F(ConsTest, iter_after_cdr)
+{
+    Var v = VarList{ { s, t } };
+    auto j = make_iter(v);
+    ASSERT_EQ(s, j->get());
+    list_cdr(v);  // note: as by a call made while iterating
+    ASSERT_EQ(t, j->get());
+    ASSERT_EQ(nullptr, j->get());
+}
+
+TEST_F(ConsTest, list_cdr_view)
+{
+    Var v = VarList{ { s, t, s } };
+    auto d = list_cdr(v);
+    ASSERT_TRUE(holds_alternative<VarView>(v));
+    ASSERT_EQ(1, get<VarView>(*d).i);
+    ASSERT_EQ((vector<EnvEntry>{t, s}), normal_list(*d).v);
+    auto e = view_cdr(get<VarView>(*d));
+    ASSERT_EQ((vector<EnvEntry>{s}), normal_list(*e).v);
+    ASSERT_EQ(nullptr, get<VarCons>(*view_cdr(get<VarView>(*e))).c);
+}
+
+TEST_F(ConsTest, nonlist_cdr_view)
+{
+    Var v = VarNonlist{ { s, t, s } };
+    auto d = list_cdr(v);
+    ASSERT_TRUE(holds_alternative<VarView>(*d));
+    ASSERT_EQ(s, view_cdr(get<VarView>(*d)));
+}
+
+TEST_F(ConsTest, unview)
+{
+    Var v = VarList{ { s, t } };
+    auto d = list_cdr(v);
+    unview(*d);
+    ASSERT_EQ(t, get<VarCons>(*d).c->a);
+    view_sync(v);
+    auto & c = get<VarCons>(v).c;
+    ASSERT_EQ(s, c->a);
+    ASSERT_EQ(get<VarCons>(*d).c, get<ConsPtr>(c->d));
+}
+
+TEST_F(ConsTest, long_chain_release)
+{
+    ConsPtr c;
+    for (int i = 0; i != 300000; ++i)
+        c = make_cons(s, c);
+    auto h = c;
+    weak_ptr<Cons> w = get<ConsPtr>(c->d);
+    c = nullptr;
+    ASSERT_FALSE(w.expired());  // note: held by the head
+    h = nullptr;
+    ASSERT_TRUE(w.expired());
+}
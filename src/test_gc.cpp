@@ -0,0 +1,127 @@
+#include "gc.hpp"
+#include "cons.hpp"
+#include "hashtab.hpp"
+#include "gtest/gtest.h"
+
+using namespace humble;
+using namespace std;
+
+namespace {
+
+EnvEntry num(long long i) { return make_shared<Var>(VarNum{i}); }
+
+bool same_num(Var & a, Var & b)
+{
+    return get<VarNum>(a).i == get<VarNum>(b).i;
+}
+
+constexpr int T_TABLE = 1000;
+
+void delete_table(void * u) { delete static_cast<HashTable *>(u); }
+
+void walk_table(void * u, const function<void(EnvEntry &)> & f)
+{
+    static_cast<HashTable *>(u)->walk(f);
+}
+
+} // ans
+
+TEST(GcTest, cons_ring)
+{
+    weak_ptr<Var> w;
+    weak_ptr<Cons> u;
+    {
+        vector<EnvEntry> v{num(1), num(2), num(3)};
+        ConsPtr last;
+        auto c = Cons::from_list(v, last).c;
+        last->d = c;
+        w = v[1];
+        u = c;
+        gc_candidate(last);
+    }
+    ASSERT_FALSE(u.expired());
+    ASSERT_EQ(6, gc_collect());  // cells and elements
+    ASSERT_TRUE(u.expired());
+    ASSERT_TRUE(w.expired());
+}
+
+TEST(GcTest, list_in_itself)
+{
+    weak_ptr<Var> w;
+    {
+        auto e = make_shared<Var>(VarList{{num(1)}});
+        get<VarList>(*e).v.push_back(e);
+        w = e;
+        gc_candidate(e);
+    }
+    ASSERT_FALSE(w.expired());
+    gc_collect();
+    ASSERT_TRUE(w.expired());
+}
+
+TEST(GcTest, held_from_outside)
+{
+    auto e = make_shared<Var>(VarRec{{num(1)}});
+    auto f = make_shared<Var>(VarRec{{e}});
+    get<VarRec>(*e).v.push_back(f);
+    weak_ptr<Var> w = f;
+    gc_candidate(f);
+    ASSERT_EQ(0, gc_collect());
+    ASSERT_EQ(1, get<VarNum>(*get<VarRec>(*e).v[0]).i);
+    ASSERT_FALSE(w.expired());
+    gc_candidate(f);
+    e = nullptr;
+    f = nullptr;
+    ASSERT_FALSE(w.expired());
+    ASSERT_EQ(3, gc_collect());
+    ASSERT_TRUE(w.expired());
+}
+
+TEST(GcTest, live_part_keeps_what_it_reaches)
+{
+    auto a = make_shared<Var>(VarList{{num(1)}});
+    weak_ptr<Var> w;
+    {
+        auto b = make_shared<Var>(VarList{{a}});
+        get<VarList>(*a).v.push_back(b);
+        w = b;
+        gc_candidate(b);
+    }
+    ASSERT_EQ(0, gc_collect());
+    ASSERT_FALSE(w.expired());
+}
+
+TEST(GcTest, through_ext)
+{
+    gc_ext_walk(T_TABLE, walk_table);
+    weak_ptr<Var> w;
+    {
+        auto x = VarExt{T_TABLE};
+        x.u = new HashTable(hash_eqv, same_num);
+        x.f = delete_table;
+        auto e = make_shared<Var>(move(x));
+        static_cast<HashTable *>(get<VarExt>(*e).u)->set(num(1), e);
+        w = e;
+        gc_candidate(e);
+    }
+    ASSERT_FALSE(w.expired());
+    gc_collect();
+    ASSERT_TRUE(w.expired());
+}
+
+TEST(GcTest, threshold)
+{
+    auto p = gc_threshold(3);
+    weak_ptr<Var> w;
+    {
+        auto e = make_shared<Var>(VarList{{num(1)}});
+        get<VarList>(*e).v.push_back(e);
+        w = e;
+        gc_candidate(e);
+        gc_candidate(e);
+    }
+    ASSERT_FALSE(w.expired());
+    gc_candidate(num(0));  // note: reaches the threshold
+    ASSERT_TRUE(w.expired());
+    ASSERT_EQ(3, gc_threshold(p));
+}
@@ -0,0 +1,127 @@
+#include "hashtab.hpp"
+#include "cons.hpp"
+#include "gtest/gtest.h"
+
+using namespace humble;
+using namespace std;
+
+namespace {
+
+bool same_num(Var & a, Var & b)
+{
+    return holds_alternative<VarNum>(a) and holds_alternative<VarNum>(b)
+        and get<VarNum>(a).i == get<VarNum>(b).i;
+}
+
+size_t hash_zero(Var &) { return 0; }
+
+// note: as eqv? for the lists used here
+bool same_var(Var & a, Var & b)
+{
+    view_sync(a);
+    view_sync(b);
+    if (holds_alternative<VarCons>(a) and holds_alternative<VarCons>(b))
+        return get<VarCons>(a).c == get<VarCons>(b).c;
+    if (holds_alternative<VarView>(a) and holds_alternative<VarView>(b))
+        return get<VarView>(a).s == get<VarView>(b).s
+            and get<VarView>(a).i == get<VarView>(b).i;
+    return &a == &b;
+}
+
+EnvEntry num(long long i) { return make_shared<Var>(VarNum{i}); }
+
+} // ans
+
+TEST(HashTableTest, set_get)
+{
+    HashTable t(hash_eqv, same_num);
+    t.set(num(1), num(10));
+    t.set(num(2), num(20));
+    auto k = num(2);
+    ASSERT_EQ(20, get<VarNum>(*t.get(k)).i);
+    t.set(num(2), num(21));
+    ASSERT_EQ(21, get<VarNum>(*t.get(k)).i);
+    ASSERT_EQ(2, t.size());
+    auto z = num(3);
+    ASSERT_EQ(nullptr, t.get(z));
+}
+
+TEST(HashTableTest, grow)
+{
+    HashTable t(hash_eqv, same_num);
+    for (int i = 0; i != 1000; ++i)
+        t.set(num(i), num(i * 2));
+    ASSERT_EQ(1000, t.size());
+    for (int i = 0; i != 1000; ++i) {
+        auto k = num(i);
+        ASSERT_EQ(i * 2, get<VarNum>(*t.get(k)).i);
+    }
+    ASSERT_EQ(1000, t.items().size());
+}
+
+TEST(HashTableTest, erase_and_reuse)
+{
+    HashTable t(hash_zero, same_num);  // all collide
+    for (int i = 0; i != 5; ++i)
+        t.set(num(i), num(i));
+    auto k = num(2);
+    ASSERT_TRUE(t.erase(k));
+    ASSERT_FALSE(t.erase(k));
+    ASSERT_EQ(nullptr, t.get(k));
+    auto m = num(4);
+    ASSERT_EQ(4, get<VarNum>(*t.get(m)).i);
+    for (int i = 0; i != 100; ++i) {
+        t.set(num(7), num(i));
+        auto j = num(7);
+        t.erase(j);
+    }
+    ASSERT_EQ(4, t.size());
+}
+
+TEST(HashTableTest, equal_hash_over_storage)
+{
+    vector<EnvEntry> x = { num(1), num(2) };
+    Var a = VarList{x};
+    ConsPtr cons_last;
+    Var b = Cons::from_list(x, cons_last);
+    ASSERT_EQ(hash_equal(a), hash_equal(b));
+    Var c = VarCons{};
+    Var d = VarList{};
+    ASSERT_EQ(hash_equal(c), hash_equal(d));
+    Var s = VarString{"x"};
+    Var t = VarString{"x"};
+    ASSERT_EQ(hash_eqv(s), hash_eqv(t));
+}
+
+TEST(HashTableTest, eqv_key_after_cdr)
+{
+    HashTable t(hash_eqv, same_var);
+    auto k = make_var(VarList{ { num(1), num(2), num(3) } });
+    t.set(k, num(9));
+    ASSERT_TRUE(holds_alternative<VarCons>(*k));  // note: set as cons
+    ASSERT_TRUE(t.get(k));
+    auto c = make_var(VarCons{get<VarCons>(*k).c});
+    ASSERT_TRUE(t.get(c));
+    auto e = make_var(VarCons{});
+    t.set(e, num(0));
+    auto f = make_var(VarCons{});
+    ASSERT_TRUE(t.get(f));
+}
+
+// note: (cdr p) twice gives two vars, each eq? to the other
+TEST(HashTableTest, eqv_key_of_tail)
+{
+    HashTable t(hash_eqv, same_var);
+    auto p = make_var(VarList{ { num(1), num(2), num(3) } });
+    auto a = list_cdr(*p);
+    auto b = view_cdr(get<VarView>(*p));
+    ASSERT_EQ(hash_eqv(*a), hash_eqv(*b));
+    t.set(a, num(9));
+    ASSERT_TRUE(t.get(b));
+    auto d = view_cdr(get<VarView>(*p));
+    ASSERT_TRUE(holds_alternative<VarView>(*d));
+    ASSERT_TRUE(t.get(d));
+    auto x = make_var(VarList{ { num(1), num(2), num(3) } });
+    auto y = list_cdr(*x);
+    ASSERT_FALSE(t.get(y));
+}
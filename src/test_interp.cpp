@@ -0,0 +1,88 @@
+#include "interp.hpp"
+#include "except.hpp"
+#include "gtest/gtest.h"
+#include <thread>
+
+using namespace humble;
+using namespace std;
+
+namespace {
+
+long long num(const EnvEntry & e) { return get<VarNum>(*e).i; }
+
+} // ans
+
+TEST(InterpTest, separate_toplevels)
+{
+    Interpreter a{""};
+    Interpreter b{""};
+    a.run("(define x 1)");
+    b.run("(define x 2)");
+    ASSERT_EQ(1, num(a.run("x")));
+    ASSERT_EQ(2, num(b.run("x")));
+    ASSERT_THROW(b.run("y"), SrcError);
+}
+
+TEST(InterpTest, names_of_each)
+{
+    Interpreter a{""};
+    Interpreter b{""};
+    a.run("(define (f) 'only-in-a)");
+    auto r = b.run("(symbol->string 'in-b)");
+    ASSERT_EQ("in-b", get<VarString>(*r).s);
+    r = a.run("(symbol->string (f))");
+    ASSERT_EQ("only-in-a", get<VarString>(*r).s);
+}
+
+TEST(InterpTest, threads)
+{
+    auto sum = [](long long & r) {
+        Interpreter h{""};
+        h.run("(define (sum n a) (if (zero? n) a (sum (- n 1) (+ a n))))");
+        r = num(h.run("(sum 20000 0)"));
+    };
+    long long r1{}, r2{};
+    thread t1(sum, ref(r1));
+    thread t2(sum, ref(r2));
+    t1.join();
+    t2.join();
+    ASSERT_EQ(200010000, r1);
+    ASSERT_EQ(200010000, r2);
+}
+
+TEST(InterpTest, clocks)
+{
+    Interpreter h{""};
+    h.run("(define (spin n) (if (zero? n) 0 (spin (- n 1))))");
+    ASSERT_LT(0, num(h.run("(current-monotonic-ns)")));
+    ASSERT_LE(0, num(h.run(
+            "(let* ((a (current-monotonic-ns)) (b (current-monotonic-ns)))"
+            "  (- b a))")));
+    ASSERT_LT(0, num(h.run(
+            "(let* ((a (current-cpu-ns)) (b (begin (spin 20000) (current-cpu-ns))))"
+            "  (- b a))")));
+    ASSERT_THROW(h.run("(current-monotonic-ns 1)"), RunError);
+    ASSERT_THROW(h.run("(current-cpu-ns 1)"), RunError);
+}
+
+TEST(InterpTest, time_it)
+{
+    Interpreter h{""};
+    h.run("(define calls 0)");
+    h.run("(define r (time-it (lambda () (set! calls (+ calls 1))) 7 3))");
+    ASSERT_EQ(10, num(h.run("calls")));
+    h.run("(define (at i) (cdr (list-ref r i)))");  // note: runs min median mean max
+    ASSERT_EQ(7, num(h.run("(at 0)")));
+    ASSERT_LE(0, num(h.run("(at 1)")));
+    ASSERT_EQ(1, num(h.run("(if (<= (at 1) (at 2) (at 4)) 1 0)")));
+    ASSERT_EQ(1, num(h.run("(if (<= (at 1) (at 3) (at 4)) 1 0)")));
+    ASSERT_THROW(h.run("(time-it (lambda () 0) 0)"), RunError);
+    ASSERT_THROW(h.run("(time-it (lambda () 0) -3)"), RunError);
+    ASSERT_THROW(h.run("(time-it (lambda () 0) 1000000000000000000)"),
+            RunError);
+    ASSERT_THROW(h.run("(time-it (lambda () 0) 5 -1)"), RunError);
+    ASSERT_THROW(h.run("(time-it (lambda () 0) \"5\")"), RunError);
+    ASSERT_THROW(h.run("(time-it (lambda () 0) 5 'w)"), RunError);
+    ASSERT_THROW(h.run("(time-it 5 5)"), RunError);
+    ASSERT_THROW(h.run("(time-it (lambda () 0))"), RunError);
+}
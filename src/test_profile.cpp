@@ -0,0 +1,100 @@
+#include "profile.hpp"
+#include "compx.hpp"
+#include "gtest/gtest.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace humble;
+using namespace std;
+
+TEST(ProfileTest, scope_stack)
+{
+    profile_on = true;
+    LexEnv a({}, {});
+    LexEnv b({}, {});
+    {
+        ProfileScope s(&a);
+        ASSERT_EQ(1, profile_stack.n);
+        ASSERT_EQ(&a, profile_stack.f[0]);
+        s.replace(&b);
+        ASSERT_EQ(&b, profile_stack.f[0]);
+    }
+    ASSERT_EQ(0, profile_stack.n);
+    profile_on = false;
+}
+
+TEST(ProfileTest, count)
+{
+    Names n{"x"};  // note: label 0 is none
+    string fn = testing::TempDir() + "humble_count";
+    count_start(fn, n);
+    LexEnv a({}, {});
+    a.label = n.intern("f");
+    a.line = 3;
+    for (int i = 0; i != 2; ++i) {
+        CountScope s(&a);
+        CountScope t(&a);
+    }
+    count_stop();
+    ASSERT_FALSE(count_on);
+    ifstream is(fn);
+    string h;
+    getline(is, h);
+    long long calls, self, incl;
+    string name;
+    is >> calls >> self >> incl >> name;
+    ASSERT_EQ(4, calls);
+    ASSERT_EQ("f:3", name);
+}
+
+TEST(ProfileTest, trace)
+{
+    Names n{"x"};
+    string fn = testing::TempDir() + "humble_trace";
+    trace_start(fn, n);
+    LexEnv a({}, {});
+    a.label = n.intern("f");
+    a.line = 3;
+    {
+        TraceScope s(&a);
+    }
+    trace_stop();
+    ASSERT_FALSE(trace_on);
+    ifstream is(fn);
+    stringstream ss;
+    ss << is.rdbuf();
+    auto t = ss.str();
+    ASSERT_EQ(0, t.find("{\"traceEvents\":["));
+    ASSERT_NE(string::npos, t.find("\"name\":\"f:3\",\"cat\":\"lambda\""));
+    ASSERT_NE(string::npos, t.find("\"ph\":\"E\""));
+}
+
+TEST(ProfileTest, trace_dump_while_recorded)
+{
+    Names n{"x"};
+    string fn = testing::TempDir() + "humble_trace_threads";
+    trace_start(fn, n);
+    LexEnv a({}, {});
+    a.label = n.intern("g");
+    auto calls = [&a] {
+        for (int i = 0; i != 50000; ++i)
+            TraceScope s(&a);
+    };
+    thread t(calls);
+    thread u(calls);
+    for (int i = 0; i != 3; ++i)
+        trace_dump(fn);
+    t.join();
+    u.join();
+    trace_stop();
+    ifstream is(fn);
+    string line;
+    size_t b = 0, e = 0;
+    while (getline(is, line)) {
+        b += line.find("\"ph\":\"B\"") != string::npos;
+        e += line.find("\"ph\":\"E\"") != string::npos;
+    }
+    ASSERT_EQ(100000u, b);
+    ASSERT_EQ(100000u, e);
+}
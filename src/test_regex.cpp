@@ -0,0 +1,77 @@
+#include "regex.hpp"
+#include "except.hpp"
+#include "gtest/gtest.h"
+
+using namespace humble;
+using namespace std;
+
+namespace {
+
+string found(const char * pattern, string_view s)
+{
+    Regex x{pattern};
+    pair<size_t, size_t> m;
+    if (not x.search(s, 0, m)) return "-";
+    return string{s.substr(m.first, m.second - m.first)};
+}
+
+} // ans
+
+TEST(RegexTest, match)
+{
+    ASSERT_TRUE(Regex("a(b|c)*d").match("abcbd"));
+    ASSERT_FALSE(Regex("a(b|c)*d").match("abcbde"));
+    ASSERT_TRUE(Regex("").match(""));
+    ASSERT_TRUE(Regex("x{2,3}").match("xxx"));
+    ASSERT_FALSE(Regex("x{2,3}").match("xxxx"));
+    ASSERT_TRUE(Regex("x{2,}").match("xxxx"));
+    ASSERT_TRUE(Regex("[^a-c]\\d+").match("z42"));
+    ASSERT_TRUE(Regex("..").match("a€"));
+    ASSERT_TRUE(Regex("[€a]+").match("a€€"));
+    ASSERT_TRUE(Regex("a{").match("a{"));
+}
+
+TEST(RegexTest, search)
+{
+    ASSERT_EQ("abbb", found("ab*", "xxabbbab"));
+    ASSERT_EQ("sam", found("s\\w*", "a sam b"));
+    ASSERT_EQ("", found("x*", "abc"));
+    ASSERT_EQ("-", found("^b", "ab"));
+    ASSERT_EQ("b", found("b$", "bab"));
+    ASSERT_EQ("-", found("a$", "bab"));
+    ASSERT_EQ("dog", found("cat|dog|do", "hotdog"));
+    ASSERT_EQ("ab", found("ab|bcdef", "abcdef"));
+    ASSERT_EQ("bcdef", found("b|bcdef", "abcdef"));
+    ASSERT_EQ("a€b", found("a.b", "€€a€b€"));
+    ASSERT_EQ("cd", found("c?d$", "abcd"));
+    Regex x{"b+"};
+    pair<size_t, size_t> m;
+    ASSERT_TRUE(x.search("abbab", 3, m));
+    ASSERT_EQ(make_pair(size_t(4), size_t(5)), m);
+}
+
+TEST(RegexTest, no_blowup)
+{
+    // note: backtracking takes exponential time on this one
+    string s(40, 'a');
+    ASSERT_FALSE(Regex("(a*)*b").match(s));
+    ASSERT_FALSE(Regex("(a|aa)*c").match(s));
+    // note: quadratic when each start is tried on its own
+    string t(100000, 'a');
+    ASSERT_EQ("-", found("a*b", t + "c"));
+    ASSERT_EQ("-", found("a*x|ab", t));
+    ASSERT_EQ("b", found("a*b", t + "cb"));
+    ASSERT_EQ(t + "b", found("a*b", t + "b"));
+}
+
+TEST(RegexTest, errors)
+{
+    ASSERT_THROW(Regex("(a"), RunError);
+    ASSERT_THROW(Regex("a)"), RunError);
+    ASSERT_THROW(Regex("[a"), RunError);
+    ASSERT_THROW(Regex("*"), RunError);
+    ASSERT_THROW(Regex("a^b"), RunError);
+    ASSERT_THROW(Regex(string(100000, '(')), RunError);
+    ASSERT_THROW(Regex("a" + string(100000, '*')), RunError);
+    Regex(string(200, '(') + "a" + string(200, ')'));
+}
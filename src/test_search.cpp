@@ -0,0 +1,52 @@
+#include "search.hpp"
+#include "except.hpp"
+#include "gtest/gtest.h"
+
+using namespace humble;
+using namespace std;
+
+TEST(OnePatternTest, as_find)
+{
+    string s = "abracadabra cadabra abracadabra";
+    for (string u : { "a", "abra", "cad", "dabra c", "abracadabra", "x",
+            "raa", "" }) {
+        OnePattern p{u};
+        for (size_t from = 0; from <= s.size() + 1; ++from) {
+            SearchMatch m;
+            auto i = s.find(u, from);
+            ASSERT_EQ(i != s.npos, p.find(s, from, m)) << u << from;
+            if (i != s.npos) {
+                ASSERT_EQ(i, m.at) << u << from;
+            }
+        }
+    }
+}
+
+TEST(ManyPatternTest, leftmost_longest)
+{
+    ManyPattern p{{ "bc", "abcd", "b", "cde" }};
+    SearchMatch m;
+    ASSERT_TRUE(p.find("xabcde", 0, m));
+    ASSERT_EQ(1, m.at);
+    ASSERT_EQ(1, m.k);
+    ASSERT_TRUE(p.find("xabcde", 2, m));
+    ASSERT_EQ(2, m.at);
+    ASSERT_EQ(0, m.k);
+    ASSERT_TRUE(p.find("xabcde", 3, m));
+    ASSERT_EQ(3, m.at);
+    ASSERT_EQ(3, m.k);
+    ASSERT_FALSE(p.find("xabcde", 4, m));
+}
+
+TEST(ManyPatternTest, shared_suffix)
+{
+    ManyPattern p{{ "she", "he", "hers" }};
+    SearchMatch m;
+    ASSERT_TRUE(p.find("ushers", 0, m));
+    ASSERT_EQ(1, m.at);
+    ASSERT_EQ(0, m.k);
+    ASSERT_TRUE(p.find("ushers", 2, m));
+    ASSERT_EQ(2, m.at);
+    ASSERT_EQ(2, m.k);
+    ASSERT_THROW(ManyPattern({ "a", "" }), RunError);
+}
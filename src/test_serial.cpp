@@ -0,0 +1,144 @@
+#include "serial.hpp"
+#include "cons.hpp"
+#include "except.hpp"
+#include "gtest/gtest.h"
+
+using namespace humble;
+using namespace std;
+
+struct SerialTest : testing::Test {
+    Names names{ "foo" };
+    EnvEntry round(EnvEntry x)
+    {
+        string s;
+        serial_write(x, names, s);
+        size_t i = 0;
+        return serial_read([&s, &i]() {
+                return i == s.size() ? -1 : static_cast<unsigned char>(s[i++]);
+                }, names);
+    }
+    EnvEntry num(long long i) { return make_shared<Var>(VarNum{i}); }
+};
+
+TEST_F(SerialTest, atoms)
+{
+    for (long long i : { 0ll, 1ll, -1ll, 300ll, -1ll << 62, LLONG_MAX }) {
+        auto r = round(num(i));
+        ASSERT_EQ(i, get<VarNum>(*r).i);
+    }
+    auto b = round(make_shared<Var>(VarBool{true}));
+    ASSERT_TRUE(get<VarBool>(*b).b);
+    auto s = round(make_shared<Var>(VarString{"a€"}));
+    ASSERT_EQ("a€", get<VarString>(*s).s);
+    auto n = round(make_shared<Var>(VarNam{0}));
+    ASSERT_EQ(0, get<VarNam>(*n).h);
+}
+
+TEST_F(SerialTest, sharing)
+{
+    auto s = make_shared<Var>(VarString{"x"});
+    auto t = make_shared<Var>(VarNonlist{{ num(1), num(2) }});
+    auto r = round(make_shared<Var>(VarList{{ s, t, s, t }}));
+    auto & v = get<VarList>(*r).v;
+    ASSERT_EQ(4, v.size());
+    ASSERT_EQ(v[0], v[2]);
+    ASSERT_EQ(v[1], v[3]);
+    ASSERT_EQ(2, get<VarNum>(*get<VarNonlist>(*v[1]).v[1]).i);
+}
+
+TEST_F(SerialTest, aliased_atoms)
+{
+    auto n = num(7);
+    auto b = make_shared<Var>(VarBool{false});
+    auto r = round(make_shared<Var>(VarList{{ n, b, n, b, num(7) }}));
+    auto & v = get<VarList>(*r).v;
+    ASSERT_EQ(v[0], v[2]);
+    ASSERT_EQ(v[1], v[3]);
+    ASSERT_NE(v[0], v[4]);
+}
+
+TEST_F(SerialTest, view_left_as_is)
+{
+    auto x = make_shared<Var>(VarList{{ num(1), num(2), num(3) }});
+    auto tail = list_cdr(*x);
+    auto r = round(make_shared<Var>(VarList{{ x, tail }}));
+    ASSERT_TRUE(holds_alternative<VarView>(*x));
+    ASSERT_TRUE(holds_alternative<VarView>(*tail));
+    ASSERT_TRUE(get<VarView>(*x).s->cells.empty());
+    auto & v = get<VarList>(*r).v;
+    auto a = get<VarCons>(*v[0]).c;
+    ASSERT_EQ(3, a->length());
+    ASSERT_EQ(get<ConsPtr>(a->d), get<VarCons>(*v[1]).c);
+
+    auto y = make_shared<Var>(VarNonlist{{ num(1), num(2), num(3) }});
+    auto u = list_cdr(*y);
+    auto w = get<VarCons>(*round(u)).c;
+    ASSERT_EQ(2, get<VarNum>(*w->a).i);
+    ASSERT_EQ(3, get<VarNum>(*get<EnvEntry>(w->d)).i);
+}
+
+TEST_F(SerialTest, depth)
+{
+    auto nest = [this](int n) {
+        auto x = num(0);
+        while (n--) x = make_shared<Var>(VarList{{ x }});
+        return x;
+    };
+    auto r = round(nest(SERIAL_DEPTH - 1));
+    ASSERT_TRUE(holds_alternative<VarList>(*r));
+    string s;
+    ASSERT_THROW(serial_write(nest(SERIAL_DEPTH), names, s), RunError);
+    s = string(1, SERIAL_VERSION);
+    for (int k = 0; k != SERIAL_DEPTH; ++k) s += "\x06\x01";  // S_LIST of 1
+    s += "\x00";
+    size_t i = 0;
+    ASSERT_THROW(serial_read([&s, &i]() {
+                return i == s.size() ? -1 : static_cast<unsigned char>(s[i++]);
+                }, names), RunError);
+}
+
+TEST_F(SerialTest, cons_tail_and_cycle)
+{
+    auto c = make_shared<Cons>(num(1), make_shared<Cons>(num(2), ConsPtr{}));
+    auto tail = make_shared<Var>(VarCons{get<ConsPtr>(c->d)});
+    auto x = make_shared<Var>(VarCons{c});
+    auto r = round(make_shared<Var>(VarList{{ x, tail }}));
+    auto & v = get<VarList>(*r).v;
+    auto a = get<VarCons>(*v[0]).c;
+    ASSERT_EQ(get<ConsPtr>(a->d), get<VarCons>(*v[1]).c);
+    ASSERT_EQ(2, a->length());
+
+    get<ConsPtr>(c->d)->d = c;  // cycle
+    auto w = round(x);
+    auto b = get<VarCons>(*w).c;
+    ASSERT_EQ(b, get<ConsPtr>(get<ConsPtr>(b->d)->d));
+    ASSERT_EQ(2, get<VarNum>(*get<ConsPtr>(b->d)->a).i);
+    get<ConsPtr>(b->d)->d = ConsPtr{};
+    get<ConsPtr>(c->d)->d = ConsPtr{};
+}
+
+TEST_F(SerialTest, errors)
+{
+    auto f = make_shared<Var>(VarExt{0});
+    string s;
+    ASSERT_THROW(serial_write(f, names, s), RunError);
+    s.clear();
+    serial_write(make_shared<Var>(VarList{{ num(1) }}), names, s);
+    s.pop_back();
+    size_t i = 0;
+    auto get = [&s, &i]() {
+        return i == s.size() ? -1 : static_cast<unsigned char>(s[i++]);
+    };
+    ASSERT_THROW(serial_read(get, names), RunError);
+    i = s.size();
+    ASSERT_EQ(nullptr, serial_read(get, names));
+    s[2] = 0;  // note: the count, so an empty contiguous list
+    s.resize(3);
+    i = 0;
+    ASSERT_THROW(serial_read(get, names), RunError);
+    s.clear();
+    serial_write(make_shared<Var>(VarString{"ab"}), names, s);
+    s[3] = '\xff';
+    i = 0;
+    ASSERT_THROW(serial_read(get, names), RunError);
+}
@@ -153,7 +153,7 @@ TEST(unescape_string, octal)
     ASSERT_EQ("\33", unescape_string(s));
 
     string t = "\\33a";
-    ASSERT_EQ("\33", unescape_string(t));
+    ASSERT_EQ("\33a", unescape_string(t));
 }
 
 TEST(intern, nonexist)
@@ -0,0 +1,171 @@
+#include "transfer.hpp"
+#include "pool.hpp"
+#include "interp.hpp"
+#include "eval.hpp"
+#include "except.hpp"
+#include "gtest/gtest.h"
+#include <thread>
+
+using namespace humble;
+using namespace std;
+
+namespace {
+
+EnvEntry num(long long i) { return make_var(VarNum{i}); }
+
+long long num(const EnvEntry & e) { return get<VarNum>(*e).i; }
+
+} // ans
+
+TEST(TransferTest, list_anew)
+{
+    auto s = make_var(VarString{"s"});
+    auto x = make_var(VarList{{num(1), s, s}});
+    Transfer t;
+    auto y = t(x);
+    ASSERT_NE(x.get(), y.get());
+    auto & v = get<VarList>(*y).v;
+    ASSERT_EQ(3u, v.size());
+    ASSERT_EQ(1, num(v[0]));
+    ASSERT_NE(s.get(), v[1].get());
+    ASSERT_EQ("s", get<VarString>(*v[1]).s);
+    ASSERT_EQ(v[1].get(), v[2].get());
+    ASSERT_EQ(y.get(), t(x).get());
+}
+
+TEST(TransferTest, cons_ring)
+{
+    vector<EnvEntry> v{num(1), num(2)};
+    ConsPtr last;
+    auto c = Cons::from_list(v, last).c;
+    last->d = make_var(VarCons{c});
+    Transfer t;
+    auto y = t(make_var(VarCons{c}));
+    auto d = get<VarCons>(*y).c;
+    ASSERT_NE(c.get(), d.get());
+    ASSERT_EQ(2, num(get<ConsPtr>(d->d)->a));
+    auto e = get<EnvEntry>(get<ConsPtr>(d->d)->d);
+    ASSERT_EQ(d.get(), get<VarCons>(*e).c.get());
+    last->d = make_var(VarVoid{});
+    get<ConsPtr>(d->d)->d = make_var(VarVoid{});
+}
+
+TEST(TransferTest, closure_captured)
+{
+    Interpreter h{""};
+    auto f = h.run("(define n (list 0)) (lambda () (set-car! n 1) n)");
+    Transfer t;
+    auto g = t(f);
+    EnvEntry a[] = {g};
+    auto r = fun_call(a);
+    ASSERT_EQ(1, num(get<VarList>(*r).v[0]));
+    ASSERT_EQ(0, num(get<VarList>(*h.run("n")).v[0]));
+}
+
+TEST(TransferTest, ext_without_copier)
+{
+    Interpreter h{""};
+    auto x = h.run("(open-input-string \"port\")");
+    Interpreter::Use u{h};
+    Transfer t;
+    ASSERT_THROW(t(x), RunError);
+    auto y = h.run("(make-hash-table)");
+    ASSERT_NE(get<VarExt>(*y).u, get<VarExt>(*t(y)).u);
+}
+
+TEST(PoolTest, all_run)
+{
+    WorkPool p(3);
+    atomic<size_t> left{100};
+    atomic<long long> sum{0};
+    for (int i = 0; i != 100; ++i)
+        p.submit([i, &sum, &left] { sum += i; --left; });
+    p.wait(left);
+    ASSERT_EQ(4950, sum);
+}
+
+TEST(PoolTest, interpreter_waits_for_its_own)
+{
+    atomic<bool> go{false};
+    atomic<bool> done{false};
+    {
+        Interpreter h{""};
+        {
+            Interpreter::Use u{h};
+            WorkPool::shared().submit([&go, &done] {
+                while (not go) this_thread::yield();
+                done = true;
+            });
+        }
+        { Interpreter g{""}; }  // not after the task of h
+        ASSERT_FALSE(done);
+        go = true;
+    }
+    ASSERT_TRUE(done);
+}
+
+TEST(PoolTest, parallel_map)
+{
+    Interpreter h{""};
+    auto r = h.run(
+            "(define (fib n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2)))))"
+            "(define k (list 10))"
+            "(parallel-map (lambda (i j) (set-car! k 0) (+ (fib i) j))"
+            " '(1 2 3 4 5 6 7 8 9 10) '(0 0 0 0 0 0 0 0 0 100))");
+    auto & v = get<VarList>(*r).v;
+    ASSERT_EQ(10u, v.size());
+    ASSERT_EQ(1, num(v[0]));
+    ASSERT_EQ(155, num(v[9]));
+    ASSERT_EQ(10, num(get<VarList>(*h.run("k")).v[0]));
+    ASSERT_THROW(h.run("(parallel-map car '(1 2))"), RunError);
+    ASSERT_TRUE(holds_alternative<VarCons>(*h.run("(parallel-map car '())")));
+}
+
+TEST(PoolTest, parallel_for_each)
+{
+    Interpreter h{""};
+    h.run("(define k (list 0))"
+            "(define t (make-hash-table))"
+            "(parallel-for-each (lambda (i) (set-car! k i) (hash-table-set! t i i))"
+            " '(1 2 3))");
+    ASSERT_EQ(0, num(get<VarList>(*h.run("k")).v[0]));
+    ASSERT_EQ(0, num(h.run("(hash-table-count t)")));
+    ASSERT_TRUE(holds_alternative<VarVoid>(*h.run(
+            "(parallel-for-each car '((1) (2)))")));
+    ASSERT_THROW(h.run("(parallel-for-each car '(1 2))"), RunError);
+}
+
+TEST(PoolTest, spawn_await)
+{
+    Interpreter h{""};
+    h.run("(define k (list 0))"
+            "(define a (spawn (lambda () (set-car! k 1) (car k))))"
+            "(define b (spawn (lambda () (car '()))))");
+    ASSERT_EQ(1, num(h.run("(await a)")));
+    ASSERT_EQ(0, num(get<VarList>(*h.run("k")).v[0]));
+    ASSERT_THROW(h.run("(await b)"), RunError);
+    auto r = h.run("(await-all (map (lambda (i) (spawn (lambda () i)))"
+            " (list 1 2 3)))");
+    ASSERT_EQ(2, num(get<VarList>(*r).v[1]));
+    ASSERT_THROW(h.run("(spawn (lambda () a))"), RunError);
+}
+
+// note: a closure that captures itself is a cycle in its copy
+TEST(TransferTest, copied_cycles_collected)
+{
+    Interpreter h{""};
+    h.run("(define (mk) (define (loop i) (if (zero? i) 0 (loop (- i 1)))) loop)"
+            "(define lp (mk))"
+            "(define (rounds n f) (unless (zero? n) (f) (rounds (- n 1) f)))");
+    auto pool_bytes = [&h] {
+        h.run("(gc)");
+        return heap_stats().pool_bytes;
+    };
+    for (auto r : {"(lambda () (parallel-map lp (list 1 2)))",
+            "(lambda () (await (spawn (lambda () (lp 3)))))"}) {
+        h.run(string("(rounds 200 ") + r + ")");
+        auto b = pool_bytes();
+        h.run(string("(rounds 2000 ") + r + ")");
+        ASSERT_EQ(b, pool_bytes()) << r;
+    }
+}
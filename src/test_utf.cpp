@@ -82,3 +82,71 @@ TEST(dec, mb4)
     ASSERT_EQ(119136, utf_value(s));
 }
 
+
+TEST(index, ascii)
+{
+    string s = "cab";
+    UtfIndex x{s};
+    ASSERT_TRUE(x.ascii);
+    ASSERT_EQ(3, x.count);
+    ASSERT_EQ(2, x.offset(s, 2));
+    ASSERT_EQ(3, x.offset(s, 3));
+}
+
+TEST(index, marks)
+{
+    string s;
+    for (int i = 0; i != 100; ++i) s += "a€";
+    UtfIndex x{s};
+    ASSERT_FALSE(x.ascii);
+    ASSERT_EQ(200, x.count);
+    for (size_t i = 0; i != 200; ++i)
+        ASSERT_EQ(i % 2 ? "€" : "a", utf_ref(s.substr(x.offset(s, i)), 0).u);
+    ASSERT_EQ(s.size(), x.offset(s, 200));
+}
+
+TEST(index, malformed_as_count)
+{
+    for (string s : { "\303a", "\200a", "a\342\202", "\342\202\254\254b",
+            "\200\200", "\360a\303\251" }) {
+        UtfIndex x{s};
+        ASSERT_EQ(utf_count(s), x.count) << s;
+        for (size_t i = 0; i != x.count; ++i)
+            ASSERT_FALSE((s[x.offset(s, i)] & 0xc0) == 0x80) << s;
+    }
+    string t = "\303a";
+    UtfIndex x{t};
+    ASSERT_EQ(1, x.offset(t, 1));
+}
+
+TEST(valid, forms)
+{
+    ASSERT_TRUE(utf_valid(""));
+    ASSERT_TRUE(utf_valid("a€bÀc𝅘𝅥𝅮"));
+    ASSERT_FALSE(utf_valid("\x80"));
+    ASSERT_FALSE(utf_valid("\xc3"));          // cut
+    ASSERT_FALSE(utf_valid("\xc0\x80"));      // overlong
+    ASSERT_FALSE(utf_valid("\xe0\x80\x80"));  // overlong
+    ASSERT_FALSE(utf_valid("\xed\xa0\x80"));  // surrogate
+    ASSERT_FALSE(utf_valid("\xf4\x90\x80\x80"));  // beyond
+    ASSERT_TRUE(utf_valid("\xf4\x8f\xbf\xbf"));
+}
+
+TEST(valid, long)
+{
+    // note: places the odd byte at each offset across vector widths
+    for (size_t k = 0; k != 70; ++k) {
+        string s(100, 'a');
+        s.replace(k, 2, "À");
+        ASSERT_TRUE(utf_valid(s));
+        ASSERT_EQ(99, utf_count(s));
+        ASSERT_EQ(k, utf_ascii_prefix(s));
+        s[k + 1] = 'a';
+        ASSERT_FALSE(utf_valid(s));
+    }
+    string t;
+    for (int i = 0; i != 50; ++i) t += "€a\xf0\x9d\x84\x9e";
+    ASSERT_TRUE(utf_valid(t));
+    ASSERT_EQ(150, utf_count(t));
+    ASSERT_EQ(UtfIndex{t}.count, utf_count(t));
+}
@@ -1,5 +1,6 @@
 #include "vars.hpp"
 #include "gtest/gtest.h"
+#include <thread>
 
 using namespace humble;
 using namespace std;
@@ -40,3 +41,45 @@ TEST(localenv, setget)
     // le.get(2);
 }
 
+
+TEST(PoolTest, reuse)
+{
+    auto a = make_var(VarNum{1});
+    Var * p = a.get();
+    a = nullptr;
+    auto b = make_var(VarNum{2});
+    ASSERT_EQ(p, b.get());
+    ASSERT_EQ(2, get<VarNum>(*b).i);
+}
+
+TEST(PoolTest, heap_counts)
+{
+    auto c = heap_counts;
+    {
+        auto a = make_var(VarString{"a"});
+        auto b = make_var(VarNum{1});
+        ASSERT_EQ(c.made[HEAP_VAR] + 2, heap_counts.made[HEAP_VAR]);
+        ASSERT_EQ(c.var_made[4] + 1, heap_counts.var_made[4]);
+        ASSERT_LT(c.bytes, heap_counts.bytes);
+        *b = VarString{"b"};
+    }
+    ASSERT_EQ(c.freed[HEAP_VAR] + 2, heap_counts.freed[HEAP_VAR]);
+    ASSERT_EQ(c.var_made[4] + 1, heap_counts.var_made[4]);  // note: at make
+    ASSERT_EQ(c.bytes, heap_counts.bytes);
+}
+
+TEST(PoolTest, remote_free)
+{
+    // note: freed on a thread that ends, the blocks are reused here
+    auto round = [] {
+        vector<EnvEntry> v;
+        for (int i = 0; i != 10000; ++i)
+            v.push_back(make_var(VarNum{i}));
+        thread([&v] { v.clear(); }).join();
+    };
+    round();
+    auto b = heap_stats().pool_bytes;
+    for (int i = 0; i != 20; ++i)
+        round();
+    ASSERT_EQ(b, heap_stats().pool_bytes);
+}
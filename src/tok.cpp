@@ -17,7 +17,7 @@ using namespace std;
 
 namespace humble {
 
-int linenumber;
+thread_local int linenumber;
 
 static const char * quotes = "'`,";
 static const char * par_beg_end = PAR_BEG PAR_END;
@@ -130,12 +130,10 @@ string unescape_string(string_view s)
                 case '5': case '6': case '7':
                           {
                               short b = s[i] - '0';
-                              while (++i != n) {
-                                  c = s[i];
-                                  if (c < '0' or '7' < c)
-                                      break;
+                              while (i + 1 != n and '0' <= s[i + 1]
+                                      and s[i + 1] <= '7') {
                                   b *= 8;
-                                  b += c - '0';
+                                  b += s[++i] - '0';
                                   if (b > 255)
                                       throw SrcError("octal overflow");
                               }
@@ -158,7 +156,11 @@ Names::Names(std::initializer_list<std::string> w)
     for (auto s : w) intern(s);
 }
 
-size_t Names::size() { return v.size(); }
+size_t Names::size()
+{
+    lock_guard<mutex> g(lock);
+    return v.size();
+}
 
 int Names::add(std::string_view name, size_t h)
 {
@@ -173,6 +175,7 @@ int Names::add(std::string_view name, size_t h)
 int Names::intern(std::string_view name)
 {
     auto h = hasher(name);
+    lock_guard<mutex> g(lock);
     for (auto [b, e] = m.equal_range(h); b != e; ++b) {
         if (v[b->second] == name) return b->second;
     }
@@ -181,6 +184,7 @@ int Names::intern(std::string_view name)
 
 std::string Names::get(int h)
 {
+    lock_guard<mutex> g(lock);
     if (static_cast<size_t>(h) >= v.size()) {
         ostringstream oss;
         oss << '[';
@@ -259,6 +263,9 @@ vector<Lex> lex(const string & s, Names & names)
                 v = LexR{};
             } else throw SrcError("# token");
         } else if (t[0] == '"') {
+            // note: the source is checked, so that an octal
+            //       escape may still give any byte.
+            if (not utf_valid(t)) throw SrcError("string not utf8");
             v = LexString{ unescape_string(t.substr(1, t.size() - 2)) };
         } else if (t[0] == '.') {
             if (t.size() != 1) throw SrcError("token starts in '.'");
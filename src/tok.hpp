@@ -9,6 +9,7 @@
 #include <utility>
 #include <variant>
 #include <map>
+#include <mutex>
 #include <span>
 #include <iosfwd>
 
@@ -17,7 +18,7 @@
 
 namespace humble {
 
-extern int linenumber;
+extern thread_local int linenumber;  // of the scan in this thread
 
 size_t spaces(const char * s, size_t n);
 
@@ -25,10 +26,12 @@ std::pair<std::string_view, size_t> tok(std::string_view s);
 
 std::string unescape_string(std::string_view s);
 
+// note: locked, as shared by the threads of parallel-map
 class Names {
     std::vector<std::string> v;
     std::multimap<size_t, int> m;
     std::hash<std::string_view> hasher;
+    std::mutex lock;
     int add(std::string_view name, size_t h);
 public:
     Names();
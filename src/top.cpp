@@ -30,7 +30,7 @@ string Opener::operator()(string name, noresolve_t)
         istreambuf_iterator<char>()};
 }
 
-void top_included(Names & names, Macros & macros, vector<LexEnv *> & local_envs)
+LexForm top_included(Names & names, Macros & macros, vector<LexEnv *> & local_envs)
 {
     string s = R"(
 (ref (caar x) (car (car x)))
@@ -104,9 +104,9 @@ void top_included(Names & names, Macros & macros, vector<LexEnv *> & local_envs)
   `(ref@ ,@args (list ,@args)))
 )";
     auto & env = GlobalEnv::initial();
-    static auto t = compx(parse(s, names, macros), names, env.keys(), local_envs);
-    // ^ keep lex tree for fun-ops refs
+    auto t = compx(parse(s, names, macros), names, env.keys(), local_envs);
     for (auto & a : t.v) run(a, env);
+    return t;
 }
 
 } // ns
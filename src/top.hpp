@@ -13,7 +13,9 @@ struct Opener : SrcOpener {
     std::string operator()(std::string name, noresolve_t);
 };
 
-void top_included(Names & names, Macros & macros, std::vector<LexEnv *> & local_envs);
+// note: the tree given is to be kept for the fun-ops refs
+[[nodiscard]] LexForm top_included(Names & names, Macros & macros,
+        std::vector<LexEnv *> & local_envs);
 
 } // ns
 
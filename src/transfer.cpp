@@ -0,0 +1,135 @@
+#include "transfer.hpp"
+#include "eval.hpp"
+#include "except.hpp"
+#include "fun_impl.hpp"
+#include "gc.hpp"
+#include <map>
+
+using namespace std;
+using namespace humble;
+
+namespace {
+
+map<int, TransferExt> exts;  // note: set at init, before threads
+
+} // ans
+
+namespace humble {
+
+void transfer_ext(int t, TransferExt f)
+{
+    exts.emplace(t, f);  // note: same for each interpreter
+}
+
+void TransferSeen::note()
+{
+    for (auto & w : vars)
+        if (auto e = w.lock()) gc_candidate(e);
+    for (auto & w : cells)
+        if (auto c = w.lock()) gc_candidate(c);
+    vars.clear();
+    cells.clear();
+}
+
+// note: the var is noted before its content is copied, for cycles
+EnvEntry Transfer::operator()(const EnvEntry & e)
+{
+    if (not e) return e;
+    if (auto p = vars.find(e.get()); p != vars.end()) {
+        if (p->second != e)  // note: not a shared ext of the original
+            seen.vars.push_back(p->second);
+        return p->second;
+    }
+    if (holds_alternative<VarExt>(*e)) {
+        auto & x = get<VarExt>(*e);
+        if (auto p = exts.find(x.t); p != exts.end() and not p->second)
+            return vars[e.get()] = e;
+    }
+    auto r = make_var(VarVoid{});
+    vars[e.get()] = r;
+    *r = copy(*e);
+    return r;
+}
+
+vector<EnvEntry> Transfer::each(const vector<EnvEntry> & v)
+{
+    vector<EnvEntry> r;
+    r.reserve(v.size());
+    for (auto & e : v)
+        r.push_back((*this)(e));
+    return r;
+}
+
+// note: along the chain by iteration, as it may be long
+ConsPtr Transfer::chain(const ConsPtr & c)
+{
+    ConsPtr head;
+    Cons * last = nullptr;
+    auto link = [&](ConsNext d) {
+        if (last) last->d = move(d);
+        else head = get<ConsPtr>(d);
+    };
+    ConsPtr p = c;
+    while (p) {
+        if (auto q = cells.find(p.get()); q != cells.end()) {
+            seen.cells.push_back(q->second);
+            link(q->second);
+            return head;
+        }
+        auto n = make_cons(nullptr, ConsPtr{});
+        cells[p.get()] = n;
+        n->a = (*this)(p->a);
+        link(n);
+        last = n.get();
+        if (holds_alternative<EnvEntry>(p->d)) {
+            last->d = (*this)(get<EnvEntry>(p->d));
+            return head;
+        }
+        p = get<ConsPtr>(p->d);
+    }
+    return head;
+}
+
+Var Transfer::copy(Var & x)
+{
+    return visit([this](auto & z) -> Var {
+        using T = decay_t<decltype(z)>;
+        if constexpr (is_same_v<T, VarString>)
+            return VarString{z.s};
+        else if constexpr (is_same_v<T, VarList> or is_same_v<T, VarNonlist>
+                or is_same_v<T, VarRec> or is_same_v<T, VarSplice>)
+            return T{each(z.v)};
+        else if constexpr (is_same_v<T, VarApply>)
+            return VarApply{each(z.a)};
+        else if constexpr (is_same_v<T, VarCons>)
+            return VarCons{chain(z.c)};
+        else if constexpr (is_same_v<T, VarView>) {
+            Var v = from_view(z);
+            return copy(v);
+        }
+        else if constexpr (is_same_v<T, VarFunOps>) {
+            auto & f = funs[z.f.get()];
+            if (not f) {
+                auto c = fun_captured(*z.f).entries();
+                FunEnv e(c.size());
+                for (size_t i = 0; i != c.size(); ++i)
+                    e.set(i, (*this)(c[i]));
+                f = fun_recaptured(*z.f, move(e));
+            }
+            return VarFunOps{f};
+        } else if constexpr (is_same_v<T, VarExt>) {
+            if (auto p = exts.find(z.t); p != exts.end()) {
+                VarExt r{z.t};
+                r.u = p->second(z.u, *this);
+                r.f = z.f;
+                return r;
+            }
+            if (z.f)
+                throw RunError("transfer of ext:" + u_names->get(z.t));
+            return VarExt{z};
+        } else
+            return z;
+    }, x);
+}
+
+} // ns
@@ -0,0 +1,46 @@
+#ifndef HUMBLE_TRANSFER
+#define HUMBLE_TRANSFER
+
+#include "vars.hpp"
+#include "cons.hpp"
+#include <unordered_map>
+
+namespace humble {
+
+// Copies that were reached again while copying, as a cycle is.  A
+// cycle of the copy is left by reference counting, so they are to
+// be noted as gc candidates on the thread that drops the copy.
+struct TransferSeen {
+    std::vector<std::weak_ptr<Var>> vars;
+    std::vector<std::weak_ptr<Cons>> cells;
+    void note();  // as candidates of this thread
+};
+
+// Deep copy of vars, for handing them to another thread.  Lists,
+// cons cells, strings, records and closures (with what they have
+// captured) are made anew, keeping the sharing and the cycles that
+// are within what is copied, so that the copy has nothing mutable
+// in common with the original.  The code of a closure and builtins
+// are immutable and shared.  An ext type is copied by its copier,
+// if one is given, else it must be copyable (without deleter).
+class Transfer {
+public:
+    EnvEntry operator()(const EnvEntry & e);
+    TransferSeen seen;
+private:
+    std::unordered_map<const void *, EnvEntry> vars;
+    std::unordered_map<const void *, ConsPtr> cells;
+    std::unordered_map<const void *, std::shared_ptr<FunOps>> funs;
+    std::vector<EnvEntry> each(const std::vector<EnvEntry> & v);
+    ConsPtr chain(const ConsPtr & c);
+    Var copy(Var & x);
+};
+
+// Copy of an ext type, or nullptr as copier for one that is shared
+// as is, being immutable once made.
+typedef void * (* TransferExt)(void * u, Transfer & t);
+void transfer_ext(int t, TransferExt f);
+
+} // ns
+
+#endif
@@ -1,6 +1,11 @@
 #include "utf.hpp"
 #include "except.hpp"
 
+#if defined(__x86_64__) or defined(__i386__)
+#include <immintrin.h>
+#define HUMBLE_UTF_X86
+#endif
+
 #ifdef DEBUG
 #include "debug.hpp"
 #endif
@@ -31,6 +36,142 @@ Glyph utf_head(std::string_view s)
     throw SrcError("invalid utf8");
 }
 
+// note: a code point starts at each byte that is not continuation
+//       (0x80 to 0xbf), as utf_count has it, so that a string not
+//       well formed has the one length.  decode fails first when
+//       such a place is referred.
+bool continuation(char c)
+{
+    return static_cast<signed char>(c) < -64;
+}
+
+size_t next_lead(std::string_view s, size_t i)
+{
+    while (++i < s.size() and continuation(s[i])) { }
+    return i;
+}
+
+// note: a continuation byte is 0x80 to 0xbf, which as signed is
+//       below -64, so the code points are the bytes above that.
+size_t ascii_prefix_scalar(const char * p, size_t n)
+{
+    size_t i = 0;
+    while (i != n and static_cast<signed char>(p[i]) >= 0) ++i;
+    return i;
+}
+
+size_t count_scalar(const char * p, size_t n)
+{
+    size_t r = 0;
+    for (size_t i = 0; i != n; ++i)
+        r += static_cast<signed char>(p[i]) > -65;
+    return r;
+}
+
+#ifdef HUMBLE_UTF_X86
+
+size_t ascii_prefix_sse2(const char * p, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        auto x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        if (int m = _mm_movemask_epi8(x); m)
+            return i + __builtin_ctz(m);
+    }
+    return i + ascii_prefix_scalar(p + i, n - i);
+}
+
+size_t count_sse2(const char * p, size_t n)
+{
+    const auto c = _mm_set1_epi8(-65);
+    size_t r = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        auto x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        r += __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(x, c)));
+    }
+    return r + count_scalar(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+size_t ascii_prefix_avx2(const char * p, size_t n)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        if (unsigned m = _mm256_movemask_epi8(x); m)
+            return i + __builtin_ctz(m);
+    }
+    return i + ascii_prefix_sse2(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+size_t count_avx2(const char * p, size_t n)
+{
+    const auto c = _mm256_set1_epi8(-65);
+    size_t r = 0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        unsigned m = _mm256_movemask_epi8(_mm256_cmpgt_epi8(x, c));
+        r += __builtin_popcount(m);
+    }
+    return r + count_sse2(p + i, n - i);
+}
+
+#endif
+
+struct UtfKernels {
+    size_t (* ascii_prefix)(const char * p, size_t n);
+    size_t (* count)(const char * p, size_t n);
+};
+
+UtfKernels pick_kernels()
+{
+#ifdef HUMBLE_UTF_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return { ascii_prefix_avx2, count_avx2 };
+    return { ascii_prefix_sse2, count_sse2 };
+#else
+    return { ascii_prefix_scalar, count_scalar };
+#endif
+}
+
+const UtfKernels & kernels()
+{
+    static const UtfKernels k = pick_kernels();
+    return k;
+}
+
+bool in(unsigned char c, unsigned char lo, unsigned char hi)
+{
+    return lo <= c and c <= hi;
+}
+
+// note: size of the well formed sequence at p, that has a
+//       non-ascii lead, or zero if not well formed.
+size_t valid_size(const unsigned char * p, size_t n)
+{
+    unsigned char u = p[0];
+    size_t k;
+    unsigned char lo = 0x80, hi = 0xbf;  // of the second byte
+    if (in(u, 0xc2, 0xdf)) k = 2;
+    else if (in(u, 0xe0, 0xef)) {
+        k = 3;
+        if (u == 0xe0) lo = 0xa0;
+        else if (u == 0xed) hi = 0x9f;
+    } else if (in(u, 0xf0, 0xf4)) {
+        k = 4;
+        if (u == 0xf0) lo = 0x90;
+        else if (u == 0xf4) hi = 0x8f;
+    } else return 0;
+    if (n < k or not in(p[1], lo, hi)) return 0;
+    for (size_t j = 2; j != k; ++j)
+        if (not in(p[j], 0x80, 0xbf)) return 0;
+    return k;
+}
+
 } // ans
 
 namespace humble {
@@ -79,6 +220,63 @@ string utf_make(long long i)
     return string{r};
 }
 
+bool utf_valid(std::string_view s)
+{
+    auto p = reinterpret_cast<const unsigned char *>(s.data());
+    size_t n = s.size();
+    size_t i = 0;
+    for (;;) {
+        i += kernels().ascii_prefix(s.data() + i, n - i);
+        // note: then the run of non-ascii, until an ascii byte
+        //       where the vector scan again takes over.
+        while (i != n and p[i] >= 0x80) {
+            size_t k = valid_size(p + i, n - i);
+            if (k == 0) return false;
+            i += k;
+        }
+        if (i == n) return true;
+    }
+}
+
+size_t utf_count(std::string_view s)
+{
+    return kernels().count(s.data(), s.size());
+}
+
+size_t utf_ascii_prefix(std::string_view s)
+{
+    return kernels().ascii_prefix(s.data(), s.size());
+}
+
+UtfIndex::UtfIndex(std::string_view s)
+    : ascii(true)
+    , count()
+{
+    size_t n = s.size();
+    size_t i = utf_ascii_prefix(s);
+    count = i;
+    if (i == n) return;
+    ascii = false;
+    for (size_t k = 0; k < i; k += UTF_INDEX_STEP)
+        marks.push_back(k);
+    if (i == 0 and continuation(s[0])) i = next_lead(s, 0);
+    while (i < n) {
+        if (count % UTF_INDEX_STEP == 0) marks.push_back(i);
+        i = next_lead(s, i);
+        ++count;
+    }
+}
+
+size_t UtfIndex::offset(std::string_view s, size_t i) const
+{
+    if (ascii) return i;
+    if (i >= count) return s.size();
+    size_t r = marks[i / UTF_INDEX_STEP];
+    for (size_t k = i % UTF_INDEX_STEP; k and r < s.size(); --k)
+        r = next_lead(s, r);
+    return r;
+}
+
 Glyph utf_ref(std::string_view s, size_t i)
 {
     Glyph t;
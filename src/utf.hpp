@@ -2,6 +2,7 @@
 #define HUMBLE_UTF
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace humble {
 
@@ -12,6 +13,28 @@ namespace humble {
 struct Glyph { std::string_view u; };
 
 Glyph utf_ref(std::string_view s, size_t i);
+
+// Byte offsets of code points in a string, by checkpoints every
+// UTF_INDEX_STEP code points, or none at all when only ascii.
+constexpr size_t UTF_INDEX_STEP = 64;
+struct UtfIndex {
+    bool ascii;
+    size_t count;  // of code points
+    std::vector<size_t> marks;
+    explicit UtfIndex(std::string_view s);
+    size_t offset(std::string_view s, size_t i) const;
+};
+
+// Bulk scans.  The count and the ascii prefix are vectorized
+// (SSE2 or AVX2, by what the cpu has) on x86 and scalar
+// otherwise.  Valid skips ascii runs by the vector scan, and
+// checks the rest a sequence at a time, scalar.  It is strict:
+// no overlong form, surrogate or code point beyond U+10FFFF.
+// A code point is counted at each byte that is not continuation.
+bool utf_valid(std::string_view s);
+size_t utf_count(std::string_view s);  // of code points
+size_t utf_ascii_prefix(std::string_view s);
+
 long long utf_value(Glyph u);
 std::string utf_make(long long i);
 
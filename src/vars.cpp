@@ -1,14 +1,118 @@
 #include "vars.hpp"
 #include "except.hpp"
+#include "utf.hpp"
+#include <mutex>
+#include <new>
+#include <utility>
 
 using namespace std;
+using namespace humble;
+
+namespace {
+
+mutex ended_mutex;
+HeapCounts ended{};
+atomic<long long> pool_bytes_all{0};
+PoolFree pool_ended;  // note: the remote list of a thread that ended
+
+void add_counts(HeapCounts & r, const HeapCounts & c)
+{
+    for (int k = 0; k != HEAP_KINDS; ++k) {
+        r.made[k] += c.made[k];
+        r.freed[k] += c.freed[k];
+    }
+    for (size_t i = 0; i != variant_size_v<Var>; ++i)
+        r.var_made[i] += c.var_made[i];
+    r.bytes += c.bytes;
+    r.peak += c.peak;  // note: at most, as the threads peak apart
+}
+
+// note: made at the first chunk of a thread, as all that allocate
+//       take one, to add the counts to the ended ones at exit.  the
+//       blocks freed to the thread after are then kept by the freer.
+struct HeapThread {
+    vector<PoolOwner *> owners;
+    ~HeapThread()
+    {
+        for (auto o : owners)
+            o->remote.exchange(&pool_ended, memory_order_acquire);
+        lock_guard<mutex> g(ended_mutex);
+        add_counts(ended, heap_counts);
+        heap_counts = {};  // note: heap_stats may be called after
+    }
+};
+
+thread_local HeapThread heap_thread;
+
+// note: that of the process unless an interpreter is in use
+thread_local GlobalEnv * thread_initial;
+
+} // ans
 
 namespace humble {
 
+HeapCounts heap_stats()
+{
+    HeapCounts r;
+    {
+        lock_guard<mutex> g(ended_mutex);
+        r = ended;
+    }
+    add_counts(r, heap_counts);
+    r.pool_bytes = pool_bytes_all;
+    return r;
+}
+
+// note: the first block of the chunk holds the owner
+void * pool_chunk(size_t n, PoolFree *& f, PoolOwner *& o)
+{
+    if (not o) {
+        o = new PoolOwner;  // note: never freed, as chunks point to it
+        heap_thread.owners.push_back(o);
+    }
+    pool_bytes_all += POOL_CHUNK;
+    auto c = static_cast<char *>(
+            ::operator new(POOL_CHUNK, align_val_t{POOL_CHUNK}));
+    *reinterpret_cast<PoolOwner **>(c) = o;
+    for (size_t i = POOL_CHUNK / n; --i > 1; ) {
+        auto b = reinterpret_cast<PoolFree *>(c + i * n);
+        b->next = f;
+        f = b;
+    }
+    return c + n;
+}
+
+PoolFree * pool_take(PoolOwner & o)
+{
+    auto r = o.remote.exchange(nullptr, memory_order_acquire);
+    if (r != &pool_ended) return r;
+    o.remote = &pool_ended;  // note: when allocating after the end
+    return nullptr;
+}
+
+void pool_remote_free(PoolOwner & o, PoolFree * b, PoolFree *& f)
+{
+    auto h = o.remote.load(memory_order_relaxed);
+    do {
+        if (h == &pool_ended) {
+            b->next = f;
+            f = b;
+            return;
+        }
+        b->next = h;
+    } while (not o.remote.compare_exchange_weak(h, b,
+                memory_order_release, memory_order_relaxed));
+}
+
 GlobalEnv & GlobalEnv::initial()
 {
     static GlobalEnv r(create_t{});
-    return r;
+    return thread_initial ? *thread_initial : r;
+}
+
+GlobalEnv * GlobalEnv::use_initial(GlobalEnv * e)
+{
+    return exchange(thread_initial, e);
 }
 
 GlobalEnv::GlobalEnv(create_t) : is_init_done{false} { };
@@ -53,9 +157,18 @@ EnvEntry OverlayEnv::get(int i)
 
 void OverlayEnv::set(int i, EnvEntry e) { m.set(i, e); }
 
-FunEnv::FunEnv(size_t n) : v(n) {}
+FunEnv::FunEnv(size_t n) : v(n) { ++heap_counts.made[HEAP_ENV]; }
 
-FunEnv::FunEnv(std::initializer_list<EnvEntry> w) : v(w) {}
+FunEnv::FunEnv(std::initializer_list<EnvEntry> w) : v(w)
+{ ++heap_counts.made[HEAP_ENV]; }
+
+FunEnv::FunEnv(const FunEnv & other) : v(other.v)
+{ ++heap_counts.made[HEAP_ENV]; }
+
+FunEnv::FunEnv(FunEnv && other) : v(move(other.v))
+{ ++heap_counts.made[HEAP_ENV]; }
+
+FunEnv::~FunEnv() { ++heap_counts.freed[HEAP_ENV]; }
 
 EnvEntry FunEnv::get(int i)
 {
@@ -64,6 +177,8 @@ EnvEntry FunEnv::get(int i)
 
 void FunEnv::set(int i, EnvEntry e) { v[i] = e; }
 
+span<EnvEntry> FunEnv::entries() { return v; }
+
 EnvEntry NullEnv::get(int)
 {
     throw CoreError("nullenv lookup");
@@ -108,6 +223,38 @@ VarExt::~VarExt()
     if (f) f(u);
 }
 
+UtfIndexRef::UtfIndexRef(UtfIndexRef && other) : p(other.p)
+{
+    other.p = nullptr;
+}
+
+UtfIndexRef & UtfIndexRef::operator=(const UtfIndexRef &)
+{
+    delete p;
+    p = nullptr;
+    return *this;
+}
+
+UtfIndexRef & UtfIndexRef::operator=(UtfIndexRef && other)
+{
+    if (this == &other) return *this;
+    delete p;
+    p = other.p;
+    other.p = nullptr;
+    return *this;
+}
+
+UtfIndexRef::~UtfIndexRef()
+{
+    delete p;
+}
+
+const UtfIndex & utf_index(VarString & v)
+{
+    if (not v.x.p) v.x.p = new UtfIndex(v.s);
+    return *v.x.p;
+}
+
 static const char * var_type_name_a[] {
     "void",        // note:  ordered as
     "number",      // Var variant index
@@ -124,6 +271,7 @@ static const char * var_type_name_a[] {
     "cons",
     "rec",
     "ext",
+    "list-view",
 };
 
 const char * var_type_name(const Var & v)
@@ -131,5 +279,16 @@ const char * var_type_name(const Var & v)
     return var_type_name_a[v.index()];
 }
 
+const char * var_type_name(size_t i)
+{
+    return var_type_name_a[i];
+}
+
+const char * heap_kind_name(int k)
+{
+    static const char * a[HEAP_KINDS]{ "var", "cons", "fun", "store", "env" };
+    return a[k];
+}
+
 } // ns
 
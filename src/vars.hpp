@@ -7,6 +7,8 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <atomic>
+#include <cstdint>
 #include <initializer_list>
 #include <span>
 #include <iosfwd>
@@ -17,7 +19,20 @@ struct VarVoid { };
 struct VarNum { long long i; };
 struct VarBool { bool b; };
 struct VarNam { int h; };
-struct VarString { std::string s; };
+struct UtfIndex;
+// Holds the code point index of a string, see utf_index.  It is
+// made when first needed, and is not kept on copy.
+struct UtfIndexRef {
+    UtfIndex * p;
+    UtfIndexRef() : p() { }
+    UtfIndexRef(const UtfIndexRef &) : p() { }
+    UtfIndexRef(UtfIndexRef && other);
+    UtfIndexRef & operator=(const UtfIndexRef &);
+    UtfIndexRef & operator=(UtfIndexRef && other);
+    ~UtfIndexRef();
+};
+struct VarString { std::string s; UtfIndexRef x = {}; };
+const UtfIndex & utf_index(VarString & v);
 // idea: have BigStr similar to LIST/CONS that
 // keeps string with a shared_ptr to avoid copy.
 // it will be slightly less efficient to access, but
@@ -36,6 +51,8 @@ struct VarFunHost;
 struct VarApply;
 struct Cons;
 struct VarCons { std::shared_ptr<Cons> c; };
+struct ListStore;
+struct VarView { std::shared_ptr<ListStore> s; size_t i; };
 struct VarExt {
     typedef void (* Deleter)(void *);
     int t;
@@ -50,9 +67,111 @@ struct VarExt {
 
 using Var = std::variant<VarVoid, VarNum, VarBool, VarNam, VarString/*4*/,
       VarList, VarNonlist, VarSplice, VarUnquote/*8*/,
-      VarFunOps, VarFunHost, VarApply, VarCons/*12*/, VarRec, VarExt>;
+      VarFunOps, VarFunHost, VarApply, VarCons/*12*/, VarRec, VarExt,
+      VarView>;
 using EnvEntry = std::shared_ptr<Var>;
 
+enum { HEAP_VAR, HEAP_CONS, HEAP_FUN, HEAP_STORE, HEAP_ENV, HEAP_KINDS };
+
+// Objects made and freed, and bytes taken from the pools, by this
+// thread.  The counts of a thread that ends are added to a total
+// kept for heap_stats, so those of a thread still running, as a
+// worker of the shared pool, are not in it, but for pool_bytes.
+// Vars are counted by type only when made, as a var may change
+// type in place.
+struct HeapCounts {
+    long long made[HEAP_KINDS];
+    long long freed[HEAP_KINDS];
+    long long var_made[std::variant_size_v<Var>];  // by type at make
+    long long bytes;
+    long long peak;
+    long long pool_bytes;  // of chunks, by all threads
+};
+inline thread_local HeapCounts heap_counts{};
+HeapCounts heap_stats();  // of ended threads and this one
+
+// Blocks of one size kept on a free list per thread, carved from
+// chunks that are never given back.  A chunk is aligned to its
+// size and starts with its owner, the list of the thread that
+// made it.  A block freed on another thread is pushed onto the
+// remote list of the owner, which takes it all when its own runs
+// out, so blocks go back to where they are taken.
+struct PoolFree { PoolFree * next; };
+struct PoolOwner { std::atomic<PoolFree *> remote{nullptr}; };
+template <size_t N> inline thread_local PoolFree * pool_free = nullptr;
+template <size_t N> inline thread_local PoolOwner * pool_owner = nullptr;
+constexpr size_t POOL_CHUNK = 1 << 16;
+// note: gives one block, the rest on f, making o if none
+void * pool_chunk(size_t n, PoolFree *& f, PoolOwner *& o);
+PoolFree * pool_take(PoolOwner & o);  // the remote list
+void pool_remote_free(PoolOwner & o, PoolFree * b, PoolFree *& f);
+
+template <typename T, int K>
+struct PoolAlloc {
+    using value_type = T;
+    template <typename U> struct rebind { using other = PoolAlloc<U, K>; };
+    static constexpr size_t N = (sizeof(T) + 15) & ~size_t(15);
+    PoolAlloc() = default;
+    template <typename U> PoolAlloc(const PoolAlloc<U, K> &) { }
+    T * allocate(size_t n)
+    {
+        static_assert(N <= POOL_CHUNK / 2);
+        if (n != 1)
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        auto & c = heap_counts;
+        c.bytes += N;
+        if (c.bytes > c.peak) c.peak = c.bytes;
+        auto & f = pool_free<N>;
+        if (not f) {
+            auto o = pool_owner<N>;
+            if (o and o->remote.load(std::memory_order_relaxed))
+                f = pool_take(*o);
+            if (not f)
+                return static_cast<T *>(pool_chunk(N, f, pool_owner<N>));
+        }
+        auto p = f;
+        f = p->next;
+        return reinterpret_cast<T *>(p);
+    }
+    void deallocate(T * p, size_t n)
+    {
+        if (n != 1)
+            return ::operator delete(p);
+        heap_counts.bytes -= N;
+        auto b = reinterpret_cast<PoolFree *>(p);
+        auto o = *reinterpret_cast<PoolOwner **>(
+                reinterpret_cast<std::uintptr_t>(p) & ~(POOL_CHUNK - 1));
+        if (o != pool_owner<N>)
+            return pool_remote_free(*o, b, pool_free<N>);
+        b->next = pool_free<N>;
+        pool_free<N> = b;
+    }
+    template <typename U, typename... A>
+    void construct(U * p, A &&... a)
+    {
+        ::new(static_cast<void *>(p)) U(std::forward<A>(a)...);
+        ++heap_counts.made[K];
+        if constexpr (std::is_same_v<U, Var>)
+            ++heap_counts.var_made[p->index()];
+    }
+    template <typename U>
+    void destroy(U * p)
+    {
+        ++heap_counts.freed[K];
+        p->~U();
+    }
+    template <typename U>
+    bool operator==(const PoolAlloc<U, K> &) const { return true; }
+};
+
+// note: var and its count are one block from the pool
+template <typename... A>
+EnvEntry make_var(A &&... a)
+{
+    return std::allocate_shared<Var>(PoolAlloc<Var, HEAP_VAR>{},
+            std::forward<A>(a)...);
+}
+
 struct VarList { std::vector<EnvEntry> v; };
 struct VarNonlist { std::vector<EnvEntry> v; };
 struct VarRec { std::vector<EnvEntry> v; };
@@ -62,6 +181,8 @@ struct VarFunHost { FunHost p; };
 struct VarApply { std::vector<EnvEntry> a; };
 
 const char * var_type_name(const Var & v);
+const char * var_type_name(size_t i);  // of variant index
+const char * heap_kind_name(int k);
 
 struct Env {
     virtual EnvEntry get(int i) = 0;
@@ -74,7 +195,8 @@ struct GlobalEnv : Env {
     // note: ^ control construction as primary use is singleton.
     // alternative: split this class in two (secondary use is
     // for testing and in the overlay env implementation)
-    static GlobalEnv & initial();
+    static GlobalEnv & initial();  // of the interpreter in use
+    static GlobalEnv * use_initial(GlobalEnv * e);  // in this thread, gives prior
     GlobalEnv(create_t);
     GlobalEnv(Env &) = delete;
     bool operator=(Env &) = delete;
@@ -101,8 +223,14 @@ struct LexEnv;
 struct FunEnv : Env {
     explicit FunEnv(size_t n);
     explicit FunEnv(std::initializer_list<EnvEntry> v);
+    FunEnv(const FunEnv & other);
+    FunEnv(FunEnv && other);
+    FunEnv & operator=(const FunEnv &) = default;
+    FunEnv & operator=(FunEnv &&) = default;
+    ~FunEnv();
     EnvEntry get(int i) override;
     void set(int i, EnvEntry e) override;
+    std::span<EnvEntry> entries();
     friend LexEnv;
 private:
     std::vector<EnvEntry> v;